@@ -2,6 +2,9 @@
 #include "Product.h"
 #include "Checkout.h"
 #include "ShoppingBag.h"
+#include "ProductPool.h"
+#include "SupermarketGameState.h"
+#include "StoreMetrics.h"
 #include "AIController.h"
 #include "NavigationSystem.h"
 #include "NavigationPath.h"
@@ -14,23 +17,77 @@
 #include "Components/CapsuleComponent.h"
 #include "Blueprint/AIBlueprintHelperLibrary.h"
 #include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
 
 AAICustomerPawn::AAICustomerPawn()
 {
     PrimaryActorTick.bCanEverTick = true;
     AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
 
+    // Montages and notifies still run, only the bone evaluation is skipped while nobody can see the customer.
+    // On a dedicated server that is always, the grab code snaps products to the hand socket there anyway.
+    GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+
     ShoppingBag = CreateDefaultSubobject<UShoppingBag>(TEXT("ShoppingBag"));
-    MaxItems = FMath::RandRange(2, 12);  // Random number between 2 and 12
+    MaxItems = 0; // Drawn from the customer's stream on the server, see PostInitializeComponents
     ShoppingTime = 300.0f; // 5 minutes
     CurrentItems = 0;
+    bInterpolatingProduct = false;
+    ProductInterpolationTime = 0.0f;
+    MoveToShelfStartTime = 0.0f;
+
+    // Movement replicates through the character movement component, a customer walking the aisles
+    // does not need more than a few updates a second. The replication graph overrides both per class.
+    NetUpdateFrequency = 10.0f;
+    NetCullDistanceSquared = FMath::Square(6000.0f);
+
+    ClientPathIndex = 0;
+    ClientFacingTarget = nullptr;
+    ClientCorrectionOffset = FVector::ZeroVector;
+}
+
+void AAICustomerPawn::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    if (HasAuthority())
+    {
+        // Customers placed in the level can initialize before the game state exists
+        ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+        Random.Initialize(GameState ? GameState->NextCustomerSeed() : FMath::Rand());
+        MaxItems = Random.RandRange(2, 12);
+
+        // Clients walk the customer themselves, see SimulateOnClient
+        if (bSimulateOnClients)
+        {
+            SetReplicateMovement(false);
+        }
+    }
 }
 
 void AAICustomerPawn::BeginPlay()
 {
     Super::BeginPlay();
     UE_LOG(LogTemp, Display, TEXT("AI BeginPlay called"));
-    InitializeAIController();
+
+    // Clients get a replicated copy without a controller, the shopping logic runs on the server
+    if (HasAuthority())
+    {
+        InitializeAIController();
+
+        if (bSimulateOnClients && GetNetMode() != NM_Standalone)
+        {
+            FTimerManagerTimerParameters TimerParameters;
+            TimerParameters.bLoop = true;
+            TimerParameters.bMaxOncePerFrame = true;
+            GetWorldTimerManager().SetTimer(CorrectionTimerHandle, this, &AAICustomerPawn::SendCorrection, CorrectionInterval, TimerParameters);
+        }
+    }
+    else if (bSimulateOnClients)
+    {
+        // Moved from SimulateOnClient, the movement component would only fight it
+        GetCharacterMovement()->SetComponentTickEnabled(false);
+    }
 }
 
 FVector AAICustomerPawn::FindMostAccessiblePoint(const TArray<FVector>& Points)
@@ -66,15 +123,24 @@ FVector AAICustomerPawn::FindMostAccessiblePoint(const TArray<FVector>& Points)
 void AAICustomerPawn::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
-    if (!AIController)
+    if (IsClientSimulated())
+    {
+        SimulateOnClient(DeltaTime);
+        return;
+    }
+
+    if (!AIController && HasAuthority())
     {
         InitializeAIController();
     }
 
+    // Turning and reaching are cosmetic, when the store is fast-forwarded they finish on the next tick
+    const bool bSkipCosmetics = ASupermarketGameState::ShouldSkipCosmeticsIn(GetWorld());
+
     if (bIsRotating)
     {
         ElapsedTime += DeltaTime;
-        float Alpha = ElapsedTime / RotationTime;
+        float Alpha = bSkipCosmetics ? 1.0f : ElapsedTime / RotationTime;
 
         FRotator CurrentRotation = GetActorRotation();
         CurrentRotation.Pitch = 0.0f;
@@ -91,6 +157,11 @@ void AAICustomerPawn::Tick(float DeltaTime)
             TryPickUpProduct();
         }
     }
+
+    if (bInterpolatingProduct)
+    {
+        InterpolateProduct(bSkipCosmetics ? MaxProductInterpolationTime : DeltaTime);
+    }
 }
 
 
@@ -107,6 +178,7 @@ void AAICustomerPawn::InitializeAIController()
         AIController = Cast<AAIController>(GetController());
         if (AIController)
         {
+            AIController->ReceiveMoveCompleted.AddUniqueDynamic(this, &AAICustomerPawn::OnMoveCompleted);
             UE_LOG(LogTemp, Display, TEXT("AIController set successfully"));
         }
         else
@@ -116,8 +188,22 @@ void AAICustomerPawn::InitializeAIController()
     }
 }
 
+void AAICustomerPawn::OnMoveCompleted(FAIRequestID RequestID, EPathFollowingResult::Type Result)
+{
+    // Aborted moves were replaced by a newer request, its own completion will follow
+    if (CurrentCheckout && Result != EPathFollowingResult::Aborted)
+    {
+        CurrentCheckout->NotifyCustomerMoveCompleted(this, Result == EPathFollowingResult::Success);
+    }
+}
+
 void AAICustomerPawn::StartShopping()
 {
+    if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+    {
+        Metrics->RecordCustomerEntered(this);
+    }
+
     CurrentItems = 0;
     ChooseProduct();
     GetWorldTimerManager().SetTimer(ShoppingTimerHandle, this, &AAICustomerPawn::FinishShopping, ShoppingTime, false);
@@ -167,13 +253,23 @@ void AAICustomerPawn::ChooseProduct()
             if (NavSys->ProjectPointToNavigation(TargetLocation, NavLocation, FVector(100, 100, 100)))
             {
                 AIController->MoveToLocation(NavLocation.Location, 10.0f, true, true, false, false, nullptr, true);
-
-                // Set up a timer to check if we've reached the shelf's access point
-                GetWorldTimerManager().SetTimer(CheckReachedShelfTimerHandle, this, &AAICustomerPawn::CheckReachedShelf, 0.1f, true);
+                ReplicateDecision(ECustomerNetAction::WalkTo, TargetShelf, NavLocation.Location);
+
+                // Set up a timer to check if we've reached the shelf's access point. At most one check per frame,
+                // a dilated frame would otherwise run several checks against the same position.
+                FTimerManagerTimerParameters TimerParameters;
+                TimerParameters.bLoop = true;
+                TimerParameters.bMaxOncePerFrame = true;
+                MoveToShelfStartTime = GetWorld()->GetTimeSeconds();
+                GetWorldTimerManager().SetTimer(CheckReachedShelfTimerHandle, this, &AAICustomerPawn::CheckReachedShelf, 0.1f, TimerParameters);
             }
             else
             {
                 UE_LOG(LogTemp, Error, TEXT("Failed to find valid navigation point for shelf access point. Choosing new product."));
+                if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+                {
+                    Metrics->RecordNavigationFailure(this);
+                }
                 CurrentShelf = nullptr;
                 GetWorldTimerManager().SetTimer(RetryTimerHandle, this, &AAICustomerPawn::ChooseProduct, 1.0f, false);
             }
@@ -200,13 +296,9 @@ void AAICustomerPawn::PutCurrentProductInBag()
         UE_LOG(LogTemp, Display, TEXT("Putting product in bag: %s"), *CurrentTargetProduct->GetProductName());
  
 
-        // Add the product to the shopping bag
+        // Add the product to the shopping bag, which keeps a record and releases the actor
         ShoppingBag->AddProduct(CurrentTargetProduct);
 
-        // Hide the product and disable its collision
-        CurrentTargetProduct->SetActorHiddenInGame(true);
-        CurrentTargetProduct->SetActorEnableCollision(false);
-
         CurrentItems++;
         UE_LOG(LogTemp, Display, TEXT("Product added to bag. Current Items: %d"), CurrentItems);
 
@@ -240,36 +332,21 @@ void AAICustomerPawn::PutCurrentProductInBag()
 
 void AAICustomerPawn::DetachAllItems()
 {
-    if (ShoppingBag)
-    {
-        TArray<AProduct*> Products = ShoppingBag->GetProducts();
-        for (AProduct* Product : Products)
-        {
-            if (Product)
-            {
-                // Detach the product from any component it might be attached to
-                Product->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-
-                // Hide the product
-                Product->SetActorHiddenInGame(true);
-                Product->SetActorEnableCollision(false);
+    bInterpolatingProduct = false;
 
-                UE_LOG(LogTemp, Display, TEXT("Detached and hidden product: %s"), *Product->GetProductName());
-            }
-        }
-    }
-    else
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Shopping bag is null when trying to detach items"));
-    }
-
-    // Clear the current target product
+    // Bagged products are only records, the product still in hand is the only actor left
     if (CurrentTargetProduct)
     {
-        CurrentTargetProduct->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-        CurrentTargetProduct->SetActorHiddenInGame(true);
-        CurrentTargetProduct->SetActorEnableCollision(false);
-        UE_LOG(LogTemp, Display, TEXT("Detached and hidden current target product: %s"), *CurrentTargetProduct->GetProductName());
+        UE_LOG(LogTemp, Display, TEXT("Releasing current target product: %s"), *CurrentTargetProduct->GetProductName());
+        ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+        if (GameState && GameState->GetProductPool())
+        {
+            GameState->GetProductPool()->Release(CurrentTargetProduct);
+        }
+        else
+        {
+            CurrentTargetProduct->Destroy();
+        }
         CurrentTargetProduct = nullptr;
     }
 
@@ -296,7 +373,7 @@ void AAICustomerPawn::PickUpProduct()
 
         // Ensure the product is visible and has collision enabled
         PickedProduct->SetActorHiddenInGame(false);
-        PickedProduct->SetActorEnableCollision(true);
+        PickedProduct->SetProductState(EProductState::Loose);
 
         // If the product has a mesh component, make sure it's visible
         UStaticMeshComponent* ProductMesh = PickedProduct->FindComponentByClass<UStaticMeshComponent>();
@@ -316,6 +393,10 @@ void AAICustomerPawn::PickUpProduct()
     else
     {
         UE_LOG(LogTemp, Warning, TEXT("Failed to pick up product from shelf %s"), *CurrentShelf->GetName());
+        if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+        {
+            Metrics->RecordFailedPick(this);
+        }
         LowerArm();
         ChooseProduct();
     }
@@ -384,12 +465,9 @@ void AAICustomerPawn::StartProductInterpolation()
 {
     if (CurrentTargetProduct)
     {
-        // Get the location of the hand socket
-        FName RightHandSocketName = FName("middle_03_rSocket");
-        FVector TargetLocation = GetMesh()->GetSocketLocation(RightHandSocketName);
-
-        // Start the interpolation timer
-        GetWorldTimerManager().SetTimer(ProductInterpolationTimerHandle, this, &AAICustomerPawn::InterpolateProduct, 0.01f, true);
+        // Moved towards the hand from Tick, so the motion follows the frame's delta at any simulation speed
+        ProductInterpolationTime = 0.0f;
+        bInterpolatingProduct = true;
     }
     else
     {
@@ -398,50 +476,38 @@ void AAICustomerPawn::StartProductInterpolation()
     }
 }
 
-void AAICustomerPawn::InterpolateProduct()
+void AAICustomerPawn::InterpolateProduct(float DeltaTime)
 {
-    if (CurrentTargetProduct)
+    if (!CurrentTargetProduct)
     {
-        FName RightHandSocketName = FName("middle_03_r");
-        FVector TargetLocation = GetMesh()->GetSocketLocation(RightHandSocketName);
-        FRotator SocketRotation = GetMesh()->GetSocketRotation(RightHandSocketName);
-
-        FVector NewLocation = FMath::VInterpTo(CurrentTargetProduct->GetActorLocation(), TargetLocation, GetWorld()->GetDeltaSeconds(), 16.0f);
-        FRotator NewRotation = FMath::RInterpTo(CurrentTargetProduct->GetActorRotation(), SocketRotation, GetWorld()->GetDeltaSeconds(), 16.0f);
+        bInterpolatingProduct = false;
+        ResetGrabAnimationFlags();
+        LowerArm();
+        return;
+    }
 
-        CurrentTargetProduct->SetActorLocationAndRotation(NewLocation, NewRotation);
+    FName RightHandSocketName = FName("middle_03_r");
+    FVector TargetLocation = GetMesh()->GetSocketLocation(RightHandSocketName);
+    FRotator SocketRotation = GetMesh()->GetSocketRotation(RightHandSocketName);
 
-        // Check if the product is close enough to the target location
-        if (FVector::Dist(NewLocation, TargetLocation) < 1.0f)
-        {
-            GetWorldTimerManager().ClearTimer(ProductInterpolationTimerHandle);
+    FVector NewLocation = FMath::VInterpTo(CurrentTargetProduct->GetActorLocation(), TargetLocation, DeltaTime, 16.0f);
+    FRotator NewRotation = FMath::RInterpTo(CurrentTargetProduct->GetActorRotation(), SocketRotation, DeltaTime, 16.0f);
 
-            // Attach the product to the hand socket
-            CurrentTargetProduct->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, RightHandSocketName);
+    CurrentTargetProduct->SetActorLocationAndRotation(NewLocation, NewRotation);
+    ProductInterpolationTime += DeltaTime;
 
-            // Lower the arm after 1 second
-            GetWorldTimerManager().SetTimer(LowerArmTimerHandle, this, &AAICustomerPawn::LowerArm, 0.01f, false);
-        }
-    }
-    else
+    // The hand keeps moving with the animation, so after a while the product is snapped to it instead of chasing it
+    if (FVector::Dist(NewLocation, TargetLocation) >= 1.0f && ProductInterpolationTime < MaxProductInterpolationTime)
     {
-        GetWorldTimerManager().ClearTimer(ProductInterpolationTimerHandle);
-        ResetGrabAnimationFlags();
-        LowerArm();
+        return;
     }
 
-    // Add a timeout check
+    bInterpolatingProduct = false;
 
-        ResetGrabAnimationFlags();
-        LowerArm();
-        if (CurrentTargetProduct)
-        {
-            CurrentTargetProduct->Destroy();
-            CurrentTargetProduct = nullptr;
-        }
-        ElapsedTime = 0.0f;
-        ChooseProduct(); // Try to choose another product
-    
+    // Attach the product to the hand socket
+    CurrentTargetProduct->AttachToComponent(GetMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, RightHandSocketName);
+
+    LowerArm();
 }
 
 void AAICustomerPawn::LowerArm()
@@ -472,13 +538,9 @@ void AAICustomerPawn::PutProductInBag(AProduct* Product)
             UE_LOG(LogTemp, Warning, TEXT("CurrentShelf is null when trying to remove product"));
         }
 
-        Product->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+        // The bag keeps a record and returns the actor to the product pool
         ShoppingBag->AddProduct(Product);
 
-        // Do not destroy the product, just hide it
-        Product->SetActorHiddenInGame(true);
-        Product->SetActorEnableCollision(false);
-
         CurrentItems++;
         UE_LOG(LogTemp, Display, TEXT("Product added to bag. Current Items: %d"), CurrentItems);
 
@@ -526,16 +588,18 @@ void AAICustomerPawn::RetryEnterCheckoutQueue()
     if (FoundCheckouts.Num() > 0)
     {
         // Choose a random checkout
-        int32 RandomIndex = FMath::RandRange(0, FoundCheckouts.Num() - 1);
+        int32 RandomIndex = Random.RandRange(0, FoundCheckouts.Num() - 1);
         ACheckout* ChosenCheckout = Cast<ACheckout>(FoundCheckouts[RandomIndex]);
 
+        // Set before entering, a customer already standing on its slot completes the move right away
+        CurrentCheckout = ChosenCheckout;
         if (ChosenCheckout && ChosenCheckout->TryEnterQueue(this))
         {
-            CurrentCheckout = ChosenCheckout;
             UE_LOG(LogTemp, Display, TEXT("AI entered checkout queue after %d attempts"), RetryCount + 1);
         }
         else
         {
+            CurrentCheckout = nullptr;
             RetryCount++;
             UE_LOG(LogTemp, Warning, TEXT("AI couldn't enter checkout queue, retrying in %.1f seconds. Attempt %d"),
                 RetryDelay, RetryCount + 1);
@@ -556,6 +620,9 @@ void AAICustomerPawn::DebugShoppingState()
 
 void AAICustomerPawn::MoveTo(const FVector& Location)
 {
+    // Checkout moves, clients take the facing from the corrections while the checkout turns the customer
+    ReplicateDecision(ECustomerNetAction::WalkTo, nullptr, Location);
+
     if (AIController)
     {
         // Use MoveToLocation with a small acceptance radius for precise movement
@@ -604,7 +671,7 @@ void AAICustomerPawn::GoToCheckout()
     if (FoundCheckouts.Num() > 0)
     {
         // Choose a random checkout
-        int32 RandomIndex = FMath::RandRange(0, FoundCheckouts.Num() - 1);
+        int32 RandomIndex = Random.RandRange(0, FoundCheckouts.Num() - 1);
         ACheckout* AvailableCheckout = Cast<ACheckout>(FoundCheckouts[RandomIndex]);
         if (AvailableCheckout)
         {
@@ -620,6 +687,7 @@ void AAICustomerPawn::GoToCheckout()
                 {
                     UE_LOG(LogTemp, Display, TEXT("Attempting to move to checkout"));
                     UAIBlueprintHelperLibrary::SimpleMoveToLocation(AIController, CheckoutNavLocation.Location);
+                    ReplicateDecision(ECustomerNetAction::WalkTo, AvailableCheckout, CheckoutNavLocation.Location);
                 }
                 else
                 {
@@ -690,9 +758,13 @@ void AAICustomerPawn::CheckReachedShelf()
         UE_LOG(LogTemp, Display, TEXT("AI reached shelf. Turning to face shelf."));
         TurnToFaceShelf();
     }
-    else if (GetWorldTimerManager().GetTimerElapsed(CheckReachedShelfTimerHandle) > 15.0f)
+    else if (GetWorld()->GetTimeSeconds() - MoveToShelfStartTime > 15.0f)
     {
         UE_LOG(LogTemp, Warning, TEXT("Failed to reach shelf after 15 seconds, choosing a new one"));
+        if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+        {
+            Metrics->RecordNavigationFailure(this);
+        }
         GetWorldTimerManager().ClearTimer(CheckReachedShelfTimerHandle);
         CurrentShelf = nullptr;
         ChooseProduct();
@@ -744,6 +816,11 @@ void AAICustomerPawn::TryPickUpProduct()
     if (!CurrentShelf || CurrentShelf->GetProductCount() == 0)
     {
         UE_LOG(LogTemp, Warning, TEXT("No current shelf or shelf is empty"));
+        UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld());
+        if (Metrics && CurrentShelf)
+        {
+            Metrics->RecordFailedPick(this);
+        }
         CurrentShelf = nullptr;
         ResetFailedNavigationAttempts();
         ChooseProduct();
@@ -767,6 +844,7 @@ void AAICustomerPawn::TryPickUpProduct()
     if (bIsCloseEnough)
     {
         DetermineShelfPosition();
+        ReplicateDecision(ECustomerNetAction::PickProduct, CurrentShelf);
         GetWorldTimerManager().SetTimer(RetryPickUpTimerHandle, this, &AAICustomerPawn::PickUpProduct, 0.5f, false);
     }
     else
@@ -778,7 +856,11 @@ void AAICustomerPawn::TryPickUpProduct()
         if (AIController)
         {
             AIController->MoveToLocation(NearestAccessPoint, 50.0f, true, true, true, false, nullptr, true);
-            GetWorldTimerManager().SetTimer(RetryPickUpTimerHandle, this, &AAICustomerPawn::CheckReachedAccessPoint, 0.5f, true);
+            ReplicateDecision(ECustomerNetAction::WalkTo, CurrentShelf, NearestAccessPoint);
+            FTimerManagerTimerParameters TimerParameters;
+            TimerParameters.bLoop = true;
+            TimerParameters.bMaxOncePerFrame = true;
+            GetWorldTimerManager().SetTimer(RetryPickUpTimerHandle, this, &AAICustomerPawn::CheckReachedAccessPoint, 0.5f, TimerParameters);
         }
         else
         {
@@ -829,7 +911,7 @@ AShelf* AAICustomerPawn::FindRandomStockedShelf()
 
     if (AccessibleStockedShelves.Num() > 0)
     {
-        int32 RandomIndex = FMath::RandRange(0, AccessibleStockedShelves.Num() - 1);
+        int32 RandomIndex = Random.RandRange(0, AccessibleStockedShelves.Num() - 1);
         return AccessibleStockedShelves[RandomIndex];
     }
 
@@ -862,6 +944,7 @@ void AAICustomerPawn::LeaveStore()
     if (AIController)
     {
         UAIBlueprintHelperLibrary::SimpleMoveToLocation(AIController, RandomLocation);
+        ReplicateDecision(ECustomerNetAction::WalkTo, nullptr, RandomLocation);
 
         // Set a timer to destroy the AI after it reaches the destination
         float EstimatedTravelTime = FVector::Dist(GetActorLocation(), RandomLocation) / GetCharacterMovement()->MaxWalkSpeed;
@@ -877,6 +960,10 @@ void AAICustomerPawn::LeaveStore()
 void AAICustomerPawn::DestroyAI()
 {
     UE_LOG(LogTemp, Display, TEXT("AI has left the store and is being destroyed"));
+    if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+    {
+        Metrics->RecordCustomerLeft(this);
+    }
     Destroy();
 }
 
@@ -926,6 +1013,10 @@ void AAICustomerPawn::CheckReachedAccessPoint()
         if (FailedNavigationAttempts >= MaxFailedNavigationAttempts)
         {
             UE_LOG(LogTemp, Warning, TEXT("Max navigation attempts reached. Choosing new product."));
+            if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+            {
+                Metrics->RecordNavigationFailure(this);
+            }
             GetWorldTimerManager().ClearTimer(RetryPickUpTimerHandle);
             CurrentShelf = nullptr;
             ResetFailedNavigationAttempts();
@@ -939,3 +1030,160 @@ void AAICustomerPawn::CheckReachedAccessPoint()
     }
     // If still moving, continue waiting
 }
+
+void AAICustomerPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME_CONDITION(AAICustomerPawn, bSimulateOnClients, COND_InitialOnly);
+    DOREPLIFETIME(AAICustomerPawn, NetDecision);
+    DOREPLIFETIME(AAICustomerPawn, NetCorrection);
+}
+
+void AAICustomerPawn::ReplicateDecision(ECustomerNetAction Action, AActor* Target, const FVector& Destination)
+{
+    if (!bSimulateOnClients || !HasAuthority() || GetNetMode() == NM_Standalone)
+    {
+        return;
+    }
+
+    NetDecision.Sequence++;
+    NetDecision.Action = Action;
+    NetDecision.Target = Target;
+    NetDecision.Destination = Destination;
+}
+
+void AAICustomerPawn::SendCorrection()
+{
+    // Only sent when it differs from the last one, a customer standing in a queue costs nothing
+    NetCorrection.Location = GetActorLocation();
+    NetCorrection.Yaw = FRotator::CompressAxisToShort(GetActorRotation().Yaw);
+}
+
+void AAICustomerPawn::OnRep_Decision()
+{
+    if (!IsClientSimulated())
+    {
+        return;
+    }
+
+    ClientFacingTarget = NetDecision.Target;
+    ClientPath.Reset();
+    ClientPathIndex = 0;
+    GetWorldTimerManager().ClearTimer(ClientGrabTimerHandle);
+    ResetGrabAnimationFlags();
+
+    switch (NetDecision.Action)
+    {
+    case ECustomerNetAction::WalkTo:
+    {
+        // Navigation points lie on the floor, the capsule's centre walks above them
+        const float HalfHeight = GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+        const UNavigationPath* Path = UNavigationSystemV1::FindPathToLocationSynchronously(GetWorld(), GetActorLocation(), NetDecision.Destination, this);
+        if (Path && Path->IsValid() && Path->PathPoints.Num() > 1)
+        {
+            for (int32 PointIndex = 1; PointIndex < Path->PathPoints.Num(); ++PointIndex)
+            {
+                ClientPath.Add(Path->PathPoints[PointIndex] + FVector(0.0f, 0.0f, HalfHeight));
+            }
+        }
+        else
+        {
+            // No client side navigation data, walk straight and let the corrections handle the rest
+            ClientPath.Add(FVector(NetDecision.Destination.X, NetDecision.Destination.Y, GetActorLocation().Z));
+        }
+        break;
+    }
+
+    case ECustomerNetAction::PickProduct:
+        // Same grab as on the server, the shelf's replicated slots say where its next product is
+        CurrentShelf = Cast<AShelf>(NetDecision.Target);
+        DetermineShelfPosition();
+        GetWorldTimerManager().SetTimer(ClientGrabTimerHandle, this, &AAICustomerPawn::ResetGrabAnimationFlags, 1.0f, false);
+        break;
+
+    case ECustomerNetAction::None:
+        break;
+    }
+}
+
+void AAICustomerPawn::OnRep_Correction()
+{
+    if (!IsClientSimulated())
+    {
+        return;
+    }
+
+    const FVector Error = FVector(NetCorrection.Location) - GetActorLocation();
+    if (Error.Size() > CorrectionSnapDistance)
+    {
+        SetActorLocation(NetCorrection.Location);
+        ClientCorrectionOffset = FVector::ZeroVector;
+    }
+    else
+    {
+        ClientCorrectionOffset = Error.Size() > CorrectionTolerance ? Error : FVector::ZeroVector;
+    }
+}
+
+void AAICustomerPawn::SimulateOnClient(float DeltaTime)
+{
+    if (DeltaTime <= 0.0f)
+    {
+        return;
+    }
+
+    const float MaxStep = GetCharacterMovement()->MaxWalkSpeed * DeltaTime;
+    FVector Location = GetActorLocation();
+
+    // Corrections are worked off at walking speed instead of popping the customer to the new place
+    if (!ClientCorrectionOffset.IsNearlyZero())
+    {
+        const FVector CorrectionStep = ClientCorrectionOffset.GetClampedToMaxSize(MaxStep);
+        Location += CorrectionStep;
+        ClientCorrectionOffset -= CorrectionStep;
+    }
+
+    // Follow the path at walking speed, several points can be passed in one long frame
+    const FVector WalkStart = Location;
+    float Remaining = MaxStep;
+    while (Remaining > 0.0f && ClientPath.IsValidIndex(ClientPathIndex))
+    {
+        const FVector ToPoint = ClientPath[ClientPathIndex] - Location;
+        const float Distance = ToPoint.Size();
+        if (Distance <= Remaining)
+        {
+            Location = ClientPath[ClientPathIndex];
+            Remaining -= Distance;
+            ++ClientPathIndex;
+        }
+        else
+        {
+            Location += ToPoint / Distance * Remaining;
+            Remaining = 0.0f;
+        }
+    }
+
+    // The animation blueprint reads the movement component's velocity
+    const FVector WalkVelocity = (Location - WalkStart) / DeltaTime;
+    GetCharacterMovement()->Velocity = WalkVelocity;
+    GetCharacterMovement()->UpdateComponentVelocity();
+
+    FRotator Rotation = GetActorRotation();
+    if (!WalkVelocity.IsNearlyZero())
+    {
+        Rotation = FMath::RInterpTo(Rotation, FRotator(0.0f, WalkVelocity.Rotation().Yaw, 0.0f), DeltaTime, 8.0f);
+    }
+    else if (ClientFacingTarget)
+    {
+        const FRotator LookAt = UKismetMathLibrary::FindLookAtRotation(Location, ClientFacingTarget->GetActorLocation());
+        Rotation = FMath::RInterpTo(Rotation, FRotator(0.0f, LookAt.Yaw, 0.0f), DeltaTime, 8.0f);
+    }
+    else if (!FVector(NetCorrection.Location).IsZero())
+    {
+        // Standing without a target, the server's facing is the one to have
+        Rotation = FMath::RInterpTo(Rotation, FRotator(0.0f, FRotator::DecompressAxisFromShort(NetCorrection.Yaw), 0.0f), DeltaTime, 8.0f);
+    }
+
+    SetActorLocationAndRotation(Location, Rotation);
+}
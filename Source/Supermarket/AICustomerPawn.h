@@ -11,6 +11,49 @@ class AShelf;
 class ACheckout;
 class AAIController;
 
+// What a client simulated customer is told to do next
+UENUM()
+enum class ECustomerNetAction : uint8
+{
+    None,
+    WalkTo,         // Walk to Destination, then face Target if there is one
+    PickProduct,    // Face the Target shelf and play the grab for its next product
+};
+
+// A key decision of the server side AI, the only state clients need to walk and animate the customer themselves
+USTRUCT()
+struct FCustomerNetDecision
+{
+    GENERATED_BODY()
+
+    // Changes with every decision, so repeating the same one still reaches clients
+    UPROPERTY()
+    uint8 Sequence = 0;
+
+    UPROPERTY()
+    ECustomerNetAction Action = ECustomerNetAction::None;
+
+    // Shelf or checkout the decision is about, may be null
+    UPROPERTY()
+    AActor* Target = nullptr;
+
+    UPROPERTY()
+    FVector_NetQuantize Destination = FVector::ZeroVector;
+};
+
+// Where the server has the customer, sent every CorrectionInterval to pull client simulations back in line
+USTRUCT()
+struct FCustomerNetCorrection
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector_NetQuantize Location = FVector::ZeroVector;
+
+    UPROPERTY()
+    uint16 Yaw = 0;
+};
+
 UCLASS()
 class SUPERMARKET_API AAICustomerPawn : public ACharacter
 {
@@ -21,6 +64,8 @@ public:
 
     virtual void Tick(float DeltaTime) override;
     virtual void BeginPlay() override;
+    virtual void PostInitializeComponents() override;
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
     UFUNCTION(BlueprintCallable)
     void StartShopping();
@@ -80,6 +125,22 @@ protected:
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shopping")
     float ShoppingTime;
+
+    // Clients walk and animate the customer themselves from the server's decisions instead of receiving
+    // its movement. The server only sends the spawn seed, the decisions and a periodic position correction.
+    UPROPERTY(EditDefaultsOnly, Replicated, Category = "Networking")
+    bool bSimulateOnClients = true;
+
+    // Seconds between position corrections sent to clients
+    UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (ClampMin = "0.1", EditCondition = "bSimulateOnClients"))
+    float CorrectionInterval = 1.0f;
+
+    // Client positions closer than this to the correction are left alone, further than CorrectionSnapDistance they snap
+    UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bSimulateOnClients"))
+    float CorrectionTolerance = 50.0f;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bSimulateOnClients"))
+    float CorrectionSnapDistance = 300.0f;
     UFUNCTION(BlueprintCallable, Category = "Shopping")
     void SetCurrentShelf(AShelf* Shelf);
 
@@ -102,15 +163,18 @@ private:
     void DebugShoppingState();
     UFUNCTION()
     void CheckReachedShelf();
+    UFUNCTION()
+    void OnMoveCompleted(FAIRequestID RequestID, EPathFollowingResult::Type Result);
     void TurnToFaceShelf();
     void TryPickUpProduct();
     AShelf* FindRandomStockedShelf();
     UPROPERTY()
     AProduct* CurrentTargetProduct;
     void StartProductInterpolation();
-    void InterpolateProduct();
-    FTimerHandle ProductInterpolationTimerHandle;
-    FTimerHandle LowerArmTimerHandle;
+    void InterpolateProduct(float DeltaTime);
+    bool bInterpolatingProduct;
+    float ProductInterpolationTime;
+    static constexpr float MaxProductInterpolationTime = 1.0f;
     FVector GetRandomLocationInStore();
     void DestroyAI();
     UFUNCTION(BlueprintCallable)
@@ -128,8 +192,39 @@ private:
     UPROPERTY()
     ACheckout* CurrentCheckout;
     FTimerHandle RetryPickUpTimerHandle;
+    float MoveToShelfStartTime;
     void CheckReachedAccessPoint();
     int32 FailedNavigationAttempts;
     static const int32 MaxFailedNavigationAttempts = 3;
     void ResetFailedNavigationAttempts() { FailedNavigationAttempts = 0; }
+
+    // Server side choices of this customer, like how much to buy and which shelf to visit. Seeded from the
+    // game state, clients never draw from it and follow the replicated decisions instead.
+    FRandomStream Random;
+
+    bool IsClientSimulated() const { return bSimulateOnClients && !HasAuthority(); }
+
+    // Server side: hands a decision to client simulations, no-op unless bSimulateOnClients
+    void ReplicateDecision(ECustomerNetAction Action, AActor* Target, const FVector& Destination = FVector::ZeroVector);
+    void SendCorrection();
+    FTimerHandle CorrectionTimerHandle;
+
+    UPROPERTY(ReplicatedUsing = OnRep_Decision)
+    FCustomerNetDecision NetDecision;
+    UFUNCTION()
+    void OnRep_Decision();
+
+    UPROPERTY(ReplicatedUsing = OnRep_Correction)
+    FCustomerNetCorrection NetCorrection;
+    UFUNCTION()
+    void OnRep_Correction();
+
+    // Client side simulation state
+    void SimulateOnClient(float DeltaTime);
+    TArray<FVector> ClientPath;
+    int32 ClientPathIndex;
+    UPROPERTY()
+    AActor* ClientFacingTarget;
+    FVector ClientCorrectionOffset;
+    FTimerHandle ClientGrabTimerHandle;
 };
\ No newline at end of file
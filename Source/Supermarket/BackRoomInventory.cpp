@@ -0,0 +1,122 @@
+// BackRoomInventory.cpp
+#include "BackRoomInventory.h"
+#include "Supermarket.h"
+#include "ProductBox.h"
+#include "Product.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+ABackRoomInventory::ABackRoomInventory()
+{
+    PrimaryActorTick.bCanEverTick = false;
+
+    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+    BoxInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("BoxInstances"));
+    BoxInstances->SetupAttachment(RootComponent);
+    BoxInstances->SetCollisionResponseToChannel(ECC_Interactable, ECR_Block);
+    BoxInstances->SetGenerateOverlapEvents(false);
+
+    ProductSpacing = FVector(2.0f, 2.0f, 2.0f);
+    GridSize = FIntVector(4, 3, 2);
+}
+
+void ABackRoomInventory::OnConstruction(const FTransform& Transform)
+{
+    Super::OnConstruction(Transform);
+
+    if (!BoxInstances->GetStaticMesh() && ProductBoxClass)
+    {
+        const AProductBox* DefaultBox = ProductBoxClass->GetDefaultObject<AProductBox>();
+        if (DefaultBox && DefaultBox->BoxMesh)
+        {
+            BoxInstances->SetStaticMesh(DefaultBox->BoxMesh->GetStaticMesh());
+        }
+    }
+
+    RebuildInstances();
+}
+
+void ABackRoomInventory::RebuildInstances()
+{
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(Boxes.Num());
+    for (const FBackRoomBox& Box : Boxes)
+    {
+        Transforms.Add(Box.Transform);
+    }
+
+    BoxInstances->ClearInstances();
+    BoxInstances->AddInstances(Transforms, false);
+}
+
+int32 ABackRoomInventory::AddBox(TSubclassOf<AProduct> ProductClass, int32 Quantity, const FTransform& WorldTransform)
+{
+    if (!ProductClass || Quantity <= 0)
+    {
+        return INDEX_NONE;
+    }
+
+    FBackRoomBox& Box = Boxes.AddDefaulted_GetRef();
+    Box.ProductClass = ProductClass;
+    Box.Quantity = Quantity;
+    Box.Transform = WorldTransform.GetRelativeTransform(GetActorTransform());
+
+    BoxInstances->AddInstance(Box.Transform);
+    return Boxes.Num() - 1;
+}
+
+AProductBox* ABackRoomInventory::TakeBox(int32 BoxIndex)
+{
+    if (!Boxes.IsValidIndex(BoxIndex) || !ProductBoxClass)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("BackRoomInventory: Can't take box %d"), BoxIndex);
+        return nullptr;
+    }
+
+    const FBackRoomBox Box = Boxes[BoxIndex];
+    const FTransform WorldTransform = Box.Transform * GetActorTransform();
+
+    // The box comes with deferred contents, its products appear once it's picked up or opened
+    AProductBox* ProductBox = AProductBox::SpawnProductBox(this, ProductBoxClass, Box.ProductClass, Box.Quantity,
+        WorldTransform.GetLocation(), ProductSpacing, GridSize);
+    if (!ProductBox)
+    {
+        return nullptr;
+    }
+    ProductBox->SetActorRotation(WorldTransform.GetRotation());
+
+    // Instances are removed in place, so Boxes and the instance indices stay in step
+    Boxes.RemoveAt(BoxIndex);
+    BoxInstances->RemoveInstance(BoxIndex);
+
+    return ProductBox;
+}
+
+bool ABackRoomInventory::StoreBox(AProductBox* Box)
+{
+    if (!Box || !Box->IsUnopened())
+    {
+        return false;
+    }
+
+    if (AddBox(Box->GetProductClass(), Box->GetProductCount(), Box->GetActorTransform()) == INDEX_NONE)
+    {
+        return false;
+    }
+
+    Box->Destroy();
+    return true;
+}
+
+int32 ABackRoomInventory::GetStoredQuantity(TSubclassOf<AProduct> ProductClass) const
+{
+    int32 Quantity = 0;
+    for (const FBackRoomBox& Box : Boxes)
+    {
+        if (Box.ProductClass == ProductClass)
+        {
+            Quantity += Box.Quantity;
+        }
+    }
+    return Quantity;
+}
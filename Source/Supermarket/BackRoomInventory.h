@@ -0,0 +1,80 @@
+// BackRoomInventory.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "BackRoomInventory.generated.h"
+
+class AProduct;
+class AProductBox;
+class UInstancedStaticMeshComponent;
+
+// An unopened box in the stockroom
+USTRUCT(BlueprintType)
+struct FBackRoomBox
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room")
+    TSubclassOf<AProduct> ProductClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room", meta = (ClampMin = "1"))
+    int32 Quantity = 1;
+
+    // Relative to the inventory actor
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room", meta = (MakeEditWidget = true))
+    FTransform Transform;
+};
+
+// The stockroom. Boxes sitting here are records drawn as instances of one box mesh, so the number of boxes
+// doesn't cost actors. A record becomes a real AProductBox only when the player takes it, and an unopened
+// box can be put back and turned into a record again. Boxes[i] is drawn by instance i.
+UCLASS()
+class SUPERMARKET_API ABackRoomInventory : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    ABackRoomInventory();
+
+    virtual void OnConstruction(const FTransform& Transform) override;
+
+    // Adds a box at the given world transform and returns its index
+    UFUNCTION(BlueprintCallable, Category = "Back Room")
+    int32 AddBox(TSubclassOf<AProduct> ProductClass, int32 Quantity, const FTransform& WorldTransform);
+
+    // Turns the record into a product box actor at the same spot and removes it from the stockroom
+    UFUNCTION(BlueprintCallable, Category = "Back Room")
+    AProductBox* TakeBox(int32 BoxIndex);
+
+    // Stores an unopened box as a record again and destroys the actor. Returns false for opened boxes.
+    UFUNCTION(BlueprintCallable, Category = "Back Room")
+    bool StoreBox(AProductBox* Box);
+
+    UFUNCTION(BlueprintCallable, Category = "Back Room")
+    int32 GetNumBoxes() const { return Boxes.Num(); }
+
+    // Units of the given product across all stored boxes
+    UFUNCTION(BlueprintCallable, Category = "Back Room")
+    int32 GetStoredQuantity(TSubclassOf<AProduct> ProductClass) const;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    UInstancedStaticMeshComponent* BoxInstances;
+
+    // Spawned by TakeBox, its box mesh is used for the instances unless one is set on BoxInstances
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room")
+    TSubclassOf<AProductBox> ProductBoxClass;
+
+    // Layout of the products once a taken box is opened
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room")
+    FVector ProductSpacing;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room")
+    FIntVector GridSize;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Back Room")
+    TArray<FBackRoomBox> Boxes;
+
+private:
+    void RebuildInstances();
+};
@@ -1,15 +1,23 @@
 // Checkout.cpp
 #include "Checkout.h"
+#include "Supermarket.h"
 #include "AICustomerPawn.h"
 #include "Product.h"
 #include "ShoppingBag.h"
+#include "ProductPool.h"
+#include "CheckoutConveyorComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/SceneComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/TextRenderComponent.h"
 #include "Components/AudioComponent.h"
 #include "SupermarketGameState.h"
+#include "StoreMetrics.h"
 #include "Kismet/GameplayStatics.h"
+#include "Animation/AnimMontage.h"
+#include "Animation/AnimSingleNodeInstance.h"
+#include "TimerManager.h"
+#include "Net/UnrealNetwork.h"
 
 ACheckout::ACheckout()
 {
@@ -19,15 +27,19 @@ ACheckout::ACheckout()
 
     CheckoutMesh = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("CheckoutMesh"));
     CheckoutMesh->SetupAttachment(RootComponent);
+    CheckoutMesh->SetCollisionResponseToChannel(ECC_Interactable, ECR_Block);
+    CheckoutMesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
 
     DisplayMonitor = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("DisplayMonitor"));
     DisplayMonitor->SetupAttachment(RootComponent);
+    DisplayMonitor->SetCollisionResponseToChannel(ECC_Interactable, ECR_Block);
 
     TotalText = CreateDefaultSubobject<UTextRenderComponent>(TEXT("TotalText"));
     TotalText->SetupAttachment(DisplayMonitor);
 
     PaymentSound = CreateDefaultSubobject<UAudioComponent>(TEXT("PaymentSound"));
     PaymentSound->SetupAttachment(RootComponent);
+    PaymentSound->bAutoActivate = false;
 
     GridStartPoint = CreateDefaultSubobject<USceneComponent>(TEXT("GridStartPoint"));
     GridStartPoint->SetupAttachment(RootComponent);
@@ -35,6 +47,13 @@ ACheckout::ACheckout()
     ScanPoint = CreateDefaultSubobject<USceneComponent>(TEXT("ScanPoint"));
     ScanPoint->SetupAttachment(RootComponent);
 
+    Conveyor = CreateDefaultSubobject<UCheckoutConveyorComponent>(TEXT("Conveyor"));
+
+    // Few per store and watched from anywhere in it, so every connection gets them
+    bReplicates = true;
+    bAlwaysRelevant = true;
+    NetUpdateFrequency = 10.0f;
+
     for (int32 i = 0; i < MaxQueueSize; ++i)
     {
         FString CompName = FString::Printf(TEXT("QueuePosition_%d"), i);
@@ -43,9 +62,6 @@ ACheckout::ACheckout()
         QueuePos->SetRelativeLocation(FVector(-100.0f * i, 0, 0));
         QueuePositions.Add(QueuePos);
     }
-
-    TotalAmount = 0.0f;
-    CurrentItemIndex = 0;
 }
 
 
@@ -66,18 +82,85 @@ void ACheckout::BeginPlay()
         TotalText->SetTextRenderColor(FColor::Green);
     }
 
+    SetupStations();
+
     ResetCheckout();
 }
 
-void ACheckout::SetupUpdateQueueTimer()
+void ACheckout::SetupStations()
+{
+    Stations.Empty();
+    Stations.SetNum(FMath::Max(1, NumStations));
+
+    // Station 0 is made of the components the checkout was designed with
+    FCheckoutStation& FirstStation = Stations[0];
+    FirstStation.CustomerPoint = QueuePositions.Num() > 0 ? QueuePositions[0] : RootComponent;
+    FirstStation.GridStartPoint = GridStartPoint;
+    FirstStation.ScanPoint = ScanPoint;
+    FirstStation.TotalText = TotalText;
+    FirstStation.Conveyor = Conveyor;
+
+    // The other stations copy station 0's layout, shifted over by StationOffset each
+    for (int32 StationIndex = 1; StationIndex < Stations.Num(); ++StationIndex)
+    {
+        FCheckoutStation& Station = Stations[StationIndex];
+
+        Station.CustomerPoint = CreateStationComponent(
+            NewObject<USceneComponent>(this, *FString::Printf(TEXT("StationCustomerPoint_%d"), StationIndex)), FirstStation.CustomerPoint, StationIndex);
+        Station.GridStartPoint = CreateStationComponent(
+            NewObject<USceneComponent>(this, *FString::Printf(TEXT("StationGridStartPoint_%d"), StationIndex)), GridStartPoint, StationIndex);
+        Station.ScanPoint = CreateStationComponent(
+            NewObject<USceneComponent>(this, *FString::Printf(TEXT("StationScanPoint_%d"), StationIndex)), ScanPoint, StationIndex);
+
+        UTextRenderComponent* StationText = NewObject<UTextRenderComponent>(this, *FString::Printf(TEXT("StationTotalText_%d"), StationIndex));
+        StationText->SetWorldSize(TotalText->WorldSize);
+        StationText->SetHorizontalAlignment(TotalText->HorizontalAlignment);
+        StationText->SetTextRenderColor(FColor::Green);
+        StationText->SetText(FText::FromString("Total: $0.00"));
+        Station.TotalText = Cast<UTextRenderComponent>(CreateStationComponent(StationText, TotalText, StationIndex));
+
+        Station.Conveyor = NewObject<UCheckoutConveyorComponent>(this, *FString::Printf(TEXT("StationConveyor_%d"), StationIndex));
+        Station.Conveyor->RegisterComponent();
+    }
+
+    for (int32 StationIndex = 0; StationIndex < Stations.Num(); ++StationIndex)
+    {
+        FCheckoutStation& Station = Stations[StationIndex];
+        if (!Station.Conveyor)
+        {
+            continue;
+        }
+
+        Station.Conveyor->ItemSpeed = ItemMoveSpeed;
+        Station.Conveyor->ScanInterval = TimeBetweenScans;
+        Station.Conveyor->OnItemScanned.AddUObject(this, &ACheckout::HandleItemScanned, StationIndex);
+        Station.Conveyor->OnEmptied.AddUObject(this, &ACheckout::HandleConveyorEmptied, StationIndex);
+
+        // The lane runs from the counter grid towards the scanner
+        FVector LaneDirection = (Station.ScanPoint->GetComponentLocation() - Station.GridStartPoint->GetComponentLocation()).GetSafeNormal2D();
+        if (LaneDirection.IsNearlyZero())
+        {
+            LaneDirection = Station.ScanPoint->GetForwardVector();
+        }
+        Station.Conveyor->SetLane(Station.ScanPoint->GetComponentLocation(), LaneDirection);
+    }
+}
+
+USceneComponent* ACheckout::CreateStationComponent(USceneComponent* NewComponent, USceneComponent* Template, int32 StationIndex)
 {
-    GetWorld()->GetTimerManager().SetTimer(UpdateQueueTimerHandle, this, &ACheckout::UpdateQueue, 0.5f, true);
+    // Place the copy where the template sits relative to the checkout, moved over by one offset per station
+    FTransform RelativeTransform = Template->GetComponentTransform().GetRelativeTransform(RootComponent->GetComponentTransform());
+    RelativeTransform.AddToTranslation(StationOffset * StationIndex);
+
+    NewComponent->SetupAttachment(RootComponent);
+    NewComponent->SetRelativeTransform(RelativeTransform);
+    NewComponent->RegisterComponent();
+    return NewComponent;
 }
 
 bool ACheckout::ProcessPayment(float Amount)
 {
-    DisplayTotal(Amount);
-    if (PaymentSound)
+    if (PaymentSound && GetNetMode() != NM_DedicatedServer)
     {
         PaymentSound->Play();
     }
@@ -86,110 +169,194 @@ bool ACheckout::ProcessPayment(float Amount)
 
 void ACheckout::DisplayTotal(float Amount)
 {
-    if (TotalText)
+    if (Stations.Num() > 0)
+    {
+        DisplayStationTotal(0, Amount);
+    }
+}
+
+void ACheckout::DisplayStationTotal(int32 StationIndex, float Amount)
+{
+    FCheckoutStation& Station = Stations[StationIndex];
+    if (HasAuthority())
+    {
+        StationTotals.SetNum(Stations.Num());
+        StationTotals[StationIndex] = Amount;
+    }
+
+    if (Station.TotalText)
     {
         FString TotalString = FString::Printf(TEXT("Total: $%.2f"), Amount);
-        TotalText->SetText(FText::FromString(TotalString));
+        Station.TotalText->SetText(FText::FromString(TotalString));
     }
     DebugLog(FString::Printf(TEXT("Total Amount: $%.2f"), Amount));
 }
 
 bool ACheckout::TryEnterQueue(AAICustomerPawn* Customer)
 {
-    if (CustomersInQueue.Num() < MaxQueueSize)
+    // QueuePositions[0] is station 0's serving spot, the rest are waiting spots
+    if (CustomersInQueue.Num() < FMath::Min(MaxQueueSize, QueuePositions.Num()) - 1)
     {
         CustomersInQueue.Add(Customer);
+        if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+        {
+            Metrics->RecordQueueJoined(Customer);
+        }
+        DispatchWaitingCustomers();
         UpdateQueue();
         return true;
     }
     return false;
 }
 
-void ACheckout::ProcessCustomer(AAICustomerPawn* Customer)
+int32 ACheckout::FindStationOfCustomer(const AAICustomerPawn* Customer) const
 {
-    if (bIsProcessingCustomer)
+    if (!Customer)
     {
-        //UE_LOG(LogTemp, Warning, TEXT("Already processing a customer. Ignoring this call."));
-        return;
+        return INDEX_NONE;
     }
+    return Stations.IndexOfByPredicate([Customer](const FCheckoutStation& Station) { return Station.Customer == Customer; });
+}
 
-    if (CustomersInQueue.Num() > 0 && QueuePositions.Num() > 0 && CustomersInQueue[0] == Customer)
-    {
-        USceneComponent* FirstQueuePosition = QueuePositions[0];
+void ACheckout::DispatchWaitingCustomers()
+{
+    // Drop customers that are gone before handing out stations
+    CustomersInQueue.RemoveAll([](const AAICustomerPawn* Customer) { return Customer == nullptr; });
 
-        if (FirstQueuePosition)
+    for (int32 StationIndex = 0; StationIndex < Stations.Num() && CustomersInQueue.Num() > 0; ++StationIndex)
+    {
+        FCheckoutStation& Station = Stations[StationIndex];
+        if (Station.Customer || Station.bIsProcessingCustomer)
         {
-            FVector CustomerLocation = Customer->GetActorLocation();
-            FVector QueueFrontLocation = FirstQueuePosition->GetComponentLocation();
+            continue;
+        }
 
-            float DistanceToQueueFront = FVector::Dist(CustomerLocation, QueueFrontLocation);
+        AAICustomerPawn* Customer = CustomersInQueue[0];
+        CustomersInQueue.RemoveAt(0);
+        AssignedQueueSlots.Remove(Customer);
+        CustomerTargetRotations.Remove(Customer);
 
-            UE_LOG(LogTemp, Display, TEXT("Customer distance to queue front: %f, Processing distance: %f"),
-                DistanceToQueueFront, ProcessingDistance);
+        DebugLog(FString::Printf(TEXT("Sending %s to station %d"), *Customer->GetName(), StationIndex));
+        if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+        {
+            Metrics->RecordServiceStarted(Customer);
+        }
+        Station.Customer = Customer;
+        Station.bCustomerArrived = false;
+        Customer->MoveTo(Station.CustomerPoint->GetComponentLocation());
 
-            if (DistanceToQueueFront <= ProcessingDistance)
-            {
-                if (Customer && Customer->ShoppingBag)
-                {
-                    UE_LOG(LogTemp, Display, TEXT("Processing customer at front of queue."));
+        // Pipelined: unload and scan the basket right away instead of waiting for the customer to walk up, they pay
+        // once they arrive. The move above may already have started the transaction if the customer was standing there.
+        if (bPipelinedCheckout && Station.Customer == Customer && !Station.bIsProcessingCustomer)
+        {
+            DebugLog(FString::Printf(TEXT("Staging basket of %s while walking up to station %d"), *Customer->GetName(), StationIndex));
+            BeginTransaction(StationIndex);
+        }
+    }
+}
 
-                    // Debug print the contents of the shopping bag
-                    Customer->ShoppingBag->DebugPrintContents();
+void ACheckout::ProcessCustomer(AAICustomerPawn* Customer)
+{
+    const int32 StationIndex = FindStationOfCustomer(Customer);
+    if (StationIndex == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Attempted to process a customer who is not at a checkout station"));
+        return;
+    }
 
-                    ProductsToScan = Customer->ShoppingBag->GetProducts();
-                    UE_LOG(LogTemp, Display, TEXT("Products in bag: %d"), ProductsToScan.Num());
+    FCheckoutStation& Station = Stations[StationIndex];
+    if (Station.bIsProcessingCustomer && Station.bCustomerArrived)
+    {
+        //UE_LOG(LogTemp, Warning, TEXT("Already processing a customer. Ignoring this call."));
+        return;
+    }
 
-                    // Clear previous items and copy new items
-                    ItemsOnCounter.Empty();
-                    ItemsOnCounter = ProductsToScan;
+    FVector CustomerLocation = Customer->GetActorLocation();
+    FVector StationLocation = Station.CustomerPoint->GetComponentLocation();
 
-                    UE_LOG(LogTemp, Display, TEXT("Items on counter: %d"), ItemsOnCounter.Num());
+    float DistanceToStation = FVector::Dist(CustomerLocation, StationLocation);
 
-                    PlaceItemsOnCounter();
+    UE_LOG(LogTemp, Display, TEXT("Customer distance to station %d: %f, Processing distance: %f"),
+        StationIndex, DistanceToStation, ProcessingDistance);
 
-                    CurrentItemIndex = 0;
-                    TotalAmount = 0.0f;
-                    ScannedItems.Empty();
-                    bIsProcessingCustomer = true;
-                    MoveNextItemToScanPosition();
-                }
-                else
-                {
-                    UE_LOG(LogTemp, Error, TEXT("Error: Customer or ShoppingBag is null"));
-                }
-            }
-            else
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Customer not close enough to queue front to be processed."));
-            }
+    if (DistanceToStation <= ProcessingDistance)
+    {
+        Station.bCustomerArrived = true;
+        if (!Station.bIsProcessingCustomer)
+        {
+            UE_LOG(LogTemp, Display, TEXT("Processing customer at station %d."), StationIndex);
+            BeginTransaction(StationIndex);
         }
-        else
+        else if (Station.Conveyor->IsEmpty())
         {
-            UE_LOG(LogTemp, Error, TEXT("Error: First queue position is null"));
+            // Pipelined basket already scanned while the customer walked up, they can pay now
+            FinishStationTransaction(StationIndex);
         }
     }
     else
     {
-        UE_LOG(LogTemp, Warning, TEXT("Attempted to process a customer who is not at the front of the queue"));
+        UE_LOG(LogTemp, Warning, TEXT("Customer not close enough to station %d to be processed."), StationIndex);
+    }
+}
+
+void ACheckout::BeginTransaction(int32 StationIndex)
+{
+    FCheckoutStation& Station = Stations[StationIndex];
+    AAICustomerPawn* Customer = Station.Customer;
+    if (!Customer || !Customer->ShoppingBag)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Error: Customer or ShoppingBag is null"));
+        return;
+    }
+
+    // Debug print the contents of the shopping bag
+    Customer->ShoppingBag->DebugPrintContents();
+
+    // The bag only holds SKU records, bring the basket back as pooled actors for the counter
+    Station.ProductsToScan.Reset();
+    Customer->ShoppingBag->MaterializeProducts(Station.GridStartPoint->GetComponentTransform(), Station.ProductsToScan);
+    UE_LOG(LogTemp, Display, TEXT("Products in bag: %d"), Station.ProductsToScan.Num());
+
+    Station.TotalCents = 0;
+    Station.ScannedItemCount = 0;
+    Station.ScannedItems.Reset();
+    Station.bIsProcessingCustomer = true;
+
+    Station.TransactionStartTime = GetWorld()->GetTimeSeconds();
+    if (Station.ThroughputStats.FirstTransactionStartTime < 0.0f)
+    {
+        Station.ThroughputStats.FirstTransactionStartTime = Station.TransactionStartTime;
+    }
+
+    // Lay the basket out on the counter and hand it to the conveyor, which scans it from there
+    PlaceItemsOnCounter(Station);
+
+    UE_LOG(LogTemp, Display, TEXT("Items on counter of station %d: %d"), StationIndex, Station.Conveyor->GetNumItems());
+
+    if (Station.Conveyor->IsEmpty() && Station.bCustomerArrived)
+    {
+        FinishStationTransaction(StationIndex);
     }
 }
 
-void ACheckout::PlaceItemsOnCounter()
+void ACheckout::PlaceItemsOnCounter(FCheckoutStation& Station)
 {
-    FVector GridOrigin = GridStartPoint->GetComponentLocation();
-    FRotator GridRotation = GridStartPoint->GetComponentRotation();
+    USceneComponent* StationGridStart = Station.GridStartPoint;
+    FVector GridOrigin = StationGridStart->GetComponentLocation();
+    FRotator GridRotation = StationGridStart->GetComponentRotation();
     FRotator StandingRotation = FRotator::MakeFromEuler(ItemStandingRotation) + GridRotation;
 
     // Get the right (Y) and forward (X) vectors of the GridStartPoint
-    FVector RightVector = GridStartPoint->GetRightVector();
-    FVector ForwardVector = GridStartPoint->GetForwardVector();
+    FVector RightVector = StationGridStart->GetRightVector();
+    FVector ForwardVector = StationGridStart->GetForwardVector();
 
+    const TArray<AProduct*>& ProductsToScan = Station.ProductsToScan;
     int32 ItemIndex = 0;
-    for (int32 Y = 0; Y < GridSize.Y && ItemIndex < ItemsOnCounter.Num(); Y++)
+    for (int32 Y = 0; Y < GridSize.Y && ItemIndex < ProductsToScan.Num(); Y++)
     {
-        for (int32 X = 0; X < GridSize.X && ItemIndex < ItemsOnCounter.Num(); X++)
+        for (int32 X = 0; X < GridSize.X && ItemIndex < ProductsToScan.Num(); X++)
         {
-            AProduct* Product = ItemsOnCounter[ItemIndex];
+            AProduct* Product = ProductsToScan[ItemIndex];
             if (Product)
             {
                 // Calculate the position on the grid aligned with GridStartPoint's negative Y direction
@@ -212,301 +379,422 @@ void ACheckout::PlaceItemsOnCounter()
 
                     // Ensure the product is visible and has collision enabled
                     Product->SetActorHiddenInGame(false);
-                    Product->SetActorEnableCollision(true);
+                    Product->SetProductState(EProductState::Loose);
                     ProductMesh->SetVisibility(true);
                 }
 
-                ItemIndex++;
+                Station.Conveyor->AddItem(Product);
             }
+            ItemIndex++;
+        }
+    }
+
+    // Anything that did not fit on the grid goes straight onto the lane
+    for (; ItemIndex < ProductsToScan.Num(); ItemIndex++)
+    {
+        if (AProduct* Product = ProductsToScan[ItemIndex])
+        {
+            Product->SetActorRotation(StandingRotation);
+            Product->SetActorHiddenInGame(false);
+            Product->SetProductState(EProductState::Loose);
+            Station.Conveyor->AddItem(Product);
         }
     }
 }
 
-void ACheckout::MoveNextItemToScanPosition()
+void ACheckout::ScanNextItem()
 {
-    if (ItemsOnCounter.Num() > 0)
+    // The conveyors scan on their own, this only pushes waiting front items through early
+    bool bScannedAny = false;
+    for (FCheckoutStation& Station : Stations)
     {
-        AProduct* NextItem = ItemsOnCounter[0];
-        if (NextItem)
+        if (Station.Conveyor && Station.Conveyor->ScanFrontItem())
         {
-            FVector StartLocation = NextItem->GetActorLocation();
-            FVector EndLocation = ScanPoint->GetComponentLocation();
-
-            // Get the product's mesh
-            UStaticMeshComponent* ProductMesh = NextItem->FindComponentByClass<UStaticMeshComponent>();
-            if (ProductMesh)
-            {
-                // Calculate the offset from the actor's origin to the bottom of the mesh
-                FVector MeshBounds = ProductMesh->Bounds.BoxExtent;
-                FVector BottomOffset = FVector(0, 0, +MeshBounds.Z);
-
-                // Adjust the end location to align the bottom of the product with the scan point
-                EndLocation += BottomOffset;
-            }
-
-            float Distance = FVector::Dist(StartLocation, EndLocation);
-            float Duration = Distance / ItemMoveSpeed;
-
-            FTimerDelegate TimerDelegate;
-            TimerDelegate.BindUFunction(this, FName("UpdateItemPosition"), NextItem, StartLocation, EndLocation, 0.0f, Duration);
-            GetWorld()->GetTimerManager().SetTimer(MoveItemTimerHandle, TimerDelegate, 0.016f, true);
+            bScannedAny = true;
         }
     }
-    else
+
+    if (!bScannedAny)
     {
-        // All items have been scanned
-        ScanNextItem();
+        DebugLog(TEXT("ScanNextItem called but no item is waiting at a scanner"));
     }
 }
 
-void ACheckout::UpdateItemPosition(AProduct* Item, FVector StartLocation, FVector EndLocation, float ElapsedTime, float Duration)
+void ACheckout::HandleItemScanned(AProduct* Product, int32 StationIndex)
 {
-    if (Item && ElapsedTime < Duration)
-    {
-        float Alpha = ElapsedTime / Duration;
-        FVector NewLocation = FMath::Lerp(StartLocation, EndLocation, Alpha);
+    DebugLog(FString::Printf(TEXT("Station %d scanning product: %s"), StationIndex, *Product->GetProductName()));
+    ScanStationItem(StationIndex, Product);
 
-        Item->SetActorLocation(NewLocation);
+    // Scanned products are done being shown
+    ReleaseProduct(Product);
+}
 
-        FTimerDelegate TimerDelegate;
-        TimerDelegate.BindUFunction(this, FName("UpdateItemPosition"), Item, StartLocation, EndLocation, ElapsedTime + 0.016f, Duration);
-        GetWorld()->GetTimerManager().SetTimer(MoveItemTimerHandle, TimerDelegate, 0.016f, false);
+void ACheckout::ReleaseProduct(AProduct* Product)
+{
+    ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+    if (GameState && GameState->GetProductPool())
+    {
+        GameState->GetProductPool()->Release(Product);
     }
-    else
+    else if (Product)
     {
-        GetWorld()->GetTimerManager().ClearTimer(MoveItemTimerHandle);
-        ScanNextItem();
+        Product->Destroy();
     }
 }
 
-void ACheckout::ScanNextItem()
+void ACheckout::HandleConveyorEmptied(int32 StationIndex)
 {
-    DebugLog(FString::Printf(TEXT("ScanNextItem called. CurrentItemIndex: %d, ProductsToScan: %d"),
-        CurrentItemIndex, ProductsToScan.Num()));
+    const FCheckoutStation& Station = Stations[StationIndex];
+    if (!Station.bIsProcessingCustomer)
+    {
+        return;
+    }
 
-    if (CurrentItemIndex < ProductsToScan.Num())
+    // Scanning can overlap the walk up, paying cannot. ProcessCustomer finishes once the customer arrives.
+    if (!Station.bCustomerArrived)
     {
-        AProduct* ProductToScan = ProductsToScan[CurrentItemIndex];
-        if (ProductToScan)
-        {
-            DebugLog(FString::Printf(TEXT("Scanning product: %s"), *ProductToScan->GetProductName()));
-            ScanItem(ProductToScan);
-            CurrentItemIndex++;
+        DebugLog(FString::Printf(TEXT("All items scanned at station %d. Waiting for the customer to arrive."), StationIndex));
+        return;
+    }
 
-            RemoveScannedItem();
+    DebugLog(FString::Printf(TEXT("All items scanned at station %d. Finishing transaction."), StationIndex));
+    FinishStationTransaction(StationIndex);
+}
 
-            // Move the next item after a short delay
-            GetWorld()->GetTimerManager().SetTimer(ScanItemTimerHandle, this, &ACheckout::MoveNextItemToScanPosition, TimeBetweenScans, false);
-        }
-        else
-        {
-            DebugLog(TEXT("Error: Product to scan is null"));
-            CurrentItemIndex++;
-            ScanNextItem();
-        }
-    }
-    else
+void ACheckout::ScanItem(AProduct* Product)
+{
+    if (Stations.Num() > 0)
     {
-        DebugLog(TEXT("All items scanned. Finishing transaction."));
-        FinishTransaction();
+        ScanStationItem(0, Product);
     }
 }
 
-void ACheckout::ScanItem(AProduct* Product)
+void ACheckout::ScanStationItem(int32 StationIndex, AProduct* Product)
 {
-    if (Product && ScanItemAnimation && CheckoutMesh)
+    if (!Product)
     {
-        CheckoutMesh->PlayAnimation(ScanItemAnimation, false);
-        TotalAmount += Product->GetPrice();
-        ScannedItems.Add(Product);
-        DisplayTotal(TotalAmount);
+        DebugLog(TEXT("Failed to scan item, product is invalid"));
+        return;
+    }
 
-        DebugLog(FString::Printf(TEXT("Scanned item: %s, Price: %.2f, New Total: %.2f"),
-            *Product->GetProductName(), Product->GetPrice(), TotalAmount));
+    // The animation is cosmetic, the item is charged with or without it.
+    // Nobody sees the scanner move on a dedicated server, skip starting the animation there.
+    // The stations share one mesh, a pipelined scan during another basket's payment leaves that animation playing.
+    if (ScanItemAnimation && CheckoutMesh && GetNetMode() != NM_DedicatedServer && !IsPaymentAnimationPlaying())
+    {
+        CheckoutMesh->PlayAnimation(ScanItemAnimation, false);
     }
-    else
+
+    FCheckoutStation& Station = Stations[StationIndex];
+    const int64 PriceCents = ASupermarketGameState::ToCents(Product->GetPrice());
+    Station.TotalCents += PriceCents;
+    Station.ScannedItemCount++;
+
+    const FName SKU = Product->GetSKU();
+    FSkuCount* SkuLine = Station.ScannedItems.FindByPredicate([SKU](const FSkuCount& Line) { return Line.SKU == SKU; });
+    if (!SkuLine)
     {
-        DebugLog(FString::Printf(TEXT("Failed to scan item. Product: %s, Animation: %s, Mesh: %s"),
-            Product ? TEXT("Valid") : TEXT("Invalid"),
-            ScanItemAnimation ? TEXT("Valid") : TEXT("Invalid"),
-            CheckoutMesh ? TEXT("Valid") : TEXT("Invalid")));
+        SkuLine = &Station.ScannedItems.AddDefaulted_GetRef();
+        SkuLine->SKU = SKU;
     }
+    SkuLine->Quantity++;
+    SkuLine->Cents += PriceCents;
+    DisplayStationTotal(StationIndex, Station.TotalCents / 100.0f);
+
+    DebugLog(FString::Printf(TEXT("Scanned item: %s, Price: %.2f, New Total: %.2f"),
+        *Product->GetProductName(), Product->GetPrice(), Station.TotalCents / 100.0f));
 }
 
 void ACheckout::FinishTransaction()
 {
-    DebugLog(TEXT("FinishTransaction called"));
+    // Kept for Blueprint callers, finishes the first station that is busy
+    const int32 StationIndex = Stations.IndexOfByPredicate([](const FCheckoutStation& Station) { return Station.bIsProcessingCustomer; });
+    if (StationIndex != INDEX_NONE)
+    {
+        FinishStationTransaction(StationIndex);
+    }
+}
+
+void ACheckout::FinishStationTransaction(int32 StationIndex)
+{
+    FCheckoutStation& Station = Stations[StationIndex];
+    DebugLog(FString::Printf(TEXT("FinishTransaction called for station %d"), StationIndex));
 
-    if (FinishTransactionAnimation && CheckoutMesh)
+    if (FinishTransactionAnimation && CheckoutMesh && GetNetMode() != NM_DedicatedServer)
     {
         CheckoutMesh->PlayAnimation(FinishTransactionAnimation, false);
     }
 
+    const float TotalAmount = Station.TotalCents / 100.0f;
+    DisplayStationTotal(StationIndex, TotalAmount);
     bool PaymentSuccessful = ProcessPayment(TotalAmount);
     if (PaymentSuccessful)
     {
-        DebugLog(FString::Printf(TEXT("Payment of $%.2f processed successfully for %d items"), TotalAmount, ScannedItems.Num()));
+        DebugLog(FString::Printf(TEXT("Payment of $%.2f processed successfully for %d items"), TotalAmount, Station.ScannedItemCount));
 
-        // Update the total money in the game state
+        // Hand the sale to the game state's ledger, it is added to the total money at the end of the frame
         if (ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>())
         {
-            GameState->AddMoney(TotalAmount);
+            FSupermarketTransaction Transaction;
+            Transaction.CheckoutId = GetFName();
+            Transaction.CustomerId = Station.Customer ? Station.Customer->GetUniqueID() : 0;
+            Transaction.Cents = Station.TotalCents;
+            Transaction.Timestamp = GetWorld()->GetTimeSeconds();
+            Transaction.Items = Station.ScannedItems;
+
+            GameState->RecordTransaction(MoveTemp(Transaction));
         }
     }
     else
     {
-        DebugLog(FString::Printf(TEXT("Payment of $%.2f failed for %d items"), TotalAmount, ScannedItems.Num()));
+        DebugLog(FString::Printf(TEXT("Payment of $%.2f failed for %d items"), TotalAmount, Station.ScannedItemCount));
     }
 
+    const float TransactionEndTime = GetWorld()->GetTimeSeconds();
+    FCheckoutThroughputStats& Stats = Station.ThroughputStats;
+    Stats.CustomersServed++;
+    Stats.ItemsScanned += Station.ScannedItemCount;
+    Stats.TotalTransactionTime += TransactionEndTime - Station.TransactionStartTime;
+    Stats.LastTransactionEndTime = TransactionEndTime;
 
-    if (CustomersInQueue.Num() > 0)
+    UE_LOG(LogTemp, Display, TEXT("Checkout %s station %d: %d customers served, average transaction %.1fs. Checkout total %.1f customers/hour (pipelined: %s)"),
+        *GetName(), StationIndex, Stats.CustomersServed, Stats.TotalTransactionTime / Stats.CustomersServed, GetCustomersPerHour(),
+        bPipelinedCheckout ? TEXT("true") : TEXT("false"));
+
+    // Free the station before the customer leaves, LeaveCheckout calls back into CustomerLeft
+    AAICustomerPawn* ProcessedCustomer = Station.Customer;
+    Station.Customer = nullptr;
+    Station.ProductsToScan.Empty();
+    Station.ScannedItemCount = 0;
+    Station.TotalCents = 0;
+    Station.ScannedItems.Reset();
+    Station.bIsProcessingCustomer = false;
+    Station.bCustomerArrived = false;
+    DisplayStationTotal(StationIndex, 0.0f);
+
+    if (ProcessedCustomer)
     {
-        AAICustomerPawn* ProcessedCustomer = CustomersInQueue[0];
-        CustomerLeft(ProcessedCustomer);
+        CustomerTargetRotations.Remove(ProcessedCustomer);
+
+        if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
+        {
+            Metrics->RecordCustomerServed(ProcessedCustomer);
+        }
 
-        // Destroy the products in the customer's shopping bag
-        if (ProcessedCustomer && ProcessedCustomer->ShoppingBag)
+        // Everything in the bag has been paid for
+        if (ProcessedCustomer->ShoppingBag)
         {
-            ProcessedCustomer->ShoppingBag->DestroyProducts();
+            ProcessedCustomer->ShoppingBag->EmptyBag();
         }
 
         ProcessedCustomer->LeaveCheckout();
     }
 
-    ScannedItems.Empty();
-    ProductsToScan.Empty();
-    TotalAmount = 0.0f;
-    CurrentItemIndex = 0;
-    DisplayTotal(0.0f);
-    bIsProcessingCustomer = false;
+    DebugLog(TEXT("Transaction finished. Station reset for next customer."));
+
+    DispatchWaitingCustomers();
+    UpdateQueue();
+}
+
+bool ACheckout::IsPaymentAnimationPlaying() const
+{
+    const UAnimSingleNodeInstance* AnimInstance = CheckoutMesh ? CheckoutMesh->GetSingleNodeInstance() : nullptr;
+    return AnimInstance && FinishTransactionAnimation
+        && AnimInstance->GetAnimationAsset() == FinishTransactionAnimation && AnimInstance->IsPlaying();
+}
+
+float ACheckout::GetCustomersPerHour() const
+{
+    const FCheckoutThroughputStats Stats = GetThroughputStats();
+    if (Stats.CustomersServed == 0)
+    {
+        return 0.0f;
+    }
+
+    const float ElapsedHours = (Stats.LastTransactionEndTime - Stats.FirstTransactionStartTime) / 3600.0f;
+    return ElapsedHours > 0.0f ? Stats.CustomersServed / ElapsedHours : 0.0f;
+}
+
+FCheckoutThroughputStats ACheckout::GetThroughputStats() const
+{
+    FCheckoutThroughputStats Combined;
+    for (const FCheckoutStation& Station : Stations)
+    {
+        const FCheckoutThroughputStats& Stats = Station.ThroughputStats;
+        if (Stats.CustomersServed == 0)
+        {
+            continue;
+        }
 
-    DebugLog(TEXT("Transaction finished. Checkout reset for next customer."));
+        Combined.CustomersServed += Stats.CustomersServed;
+        Combined.ItemsScanned += Stats.ItemsScanned;
+        Combined.TotalTransactionTime += Stats.TotalTransactionTime;
+        Combined.LastTransactionEndTime = FMath::Max(Combined.LastTransactionEndTime, Stats.LastTransactionEndTime);
+        Combined.FirstTransactionStartTime = Combined.FirstTransactionStartTime < 0.0f
+            ? Stats.FirstTransactionStartTime
+            : FMath::Min(Combined.FirstTransactionStartTime, Stats.FirstTransactionStartTime);
+    }
+    return Combined;
 }
 
 void ACheckout::CustomerLeft(AAICustomerPawn* Customer)
 {
     CustomersInQueue.Remove(Customer);
     CustomerTargetRotations.Remove(Customer);
+    AssignedQueueSlots.Remove(Customer);
+
+    // A customer walking off mid transaction cancels it: the basket goes back to the pool and nothing is recorded
+    const int32 StationIndex = FindStationOfCustomer(Customer);
+    if (StationIndex != INDEX_NONE)
+    {
+        if (Stations[StationIndex].bIsProcessingCustomer)
+        {
+            DebugLog(FString::Printf(TEXT("Customer left station %d mid transaction, cancelling it"), StationIndex));
+        }
+        ResetStation(StationIndex);
+        DispatchWaitingCustomers();
+    }
+
     UpdateQueue();
 }
 
 void ACheckout::UpdateQueue()
 {
+    NetQueueLength = CustomersInQueue.Num();
+
+    // Only customers whose slot changed get a new move, everyone else keeps standing where they are
     for (int32 i = 0; i < CustomersInQueue.Num(); ++i)
     {
-        if (CustomersInQueue[i] && QueuePositions.IsValidIndex(i))
+        AAICustomerPawn* Customer = CustomersInQueue[i];
+        const int32 SlotIndex = i + 1;
+        if (!Customer || !QueuePositions.IsValidIndex(SlotIndex))
         {
-            FVector TargetLocation = QueuePositions[i]->GetComponentLocation();
-            CustomersInQueue[i]->MoveTo(TargetLocation);
+            continue;
+        }
 
-            // Calculate and set the target rotation for each customer
-            SetCustomerTargetRotation(CustomersInQueue[i], i);
+        const int32* AssignedSlot = AssignedQueueSlots.Find(Customer);
+        if (AssignedSlot && *AssignedSlot == SlotIndex)
+        {
+            continue;
         }
+
+        AssignedQueueSlots.Add(Customer, SlotIndex);
+        CustomerTargetRotations.Remove(Customer);
+        Customer->MoveTo(QueuePositions[SlotIndex]->GetComponentLocation());
     }
+}
 
-    // Trigger the rotation update for all customers
-    StartRotationUpdate();
+void ACheckout::NotifyCustomerMoveCompleted(AAICustomerPawn* Customer, bool bSuccess)
+{
+    FVector TargetLocation;
+    FVector LookAtLocation;
 
-    if (CustomersInQueue.Num() > 0 && QueuePositions.Num() > 0)
+    const int32 StationIndex = FindStationOfCustomer(Customer);
+    const int32 SlotIndex = CustomersInQueue.Find(Customer) + 1;
+    if (StationIndex != INDEX_NONE)
     {
-        AAICustomerPawn* FrontCustomer = CustomersInQueue[0];
-        USceneComponent* FirstQueuePosition = QueuePositions[0];
+        // Customers at a station face its scanner
+        TargetLocation = Stations[StationIndex].CustomerPoint->GetComponentLocation();
+        LookAtLocation = Stations[StationIndex].ScanPoint->GetComponentLocation();
+    }
+    else if (SlotIndex > 0 && QueuePositions.IsValidIndex(SlotIndex))
+    {
+        // Waiting customers face the slot in front
+        TargetLocation = QueuePositions[SlotIndex]->GetComponentLocation();
+        LookAtLocation = QueuePositions[SlotIndex - 1]->GetComponentLocation();
+    }
+    else
+    {
+        return;
+    }
 
-        if (FrontCustomer && FirstQueuePosition)
+    const float DistanceToTarget = FVector::Dist(Customer->GetActorLocation(), TargetLocation);
+    if (!bSuccess && DistanceToTarget > ProcessingDistance)
+    {
+        // Send the customer again a bit later, retrying right away could fail the same way inside this callback
+        DebugLog(FString::Printf(TEXT("Customer %s failed to reach its checkout spot. Distance: %f"), *Customer->GetName(), DistanceToTarget));
+        if (UStoreMetrics* Metrics = UStoreMetrics::Get(GetWorld()))
         {
-            FVector CustomerLocation = FrontCustomer->GetActorLocation();
-            FVector QueueFrontLocation = FirstQueuePosition->GetComponentLocation();
-
-            float DistanceToQueueFront = FVector::Dist(CustomerLocation, QueueFrontLocation);
-
-            if (DistanceToQueueFront <= ProcessingDistance)
-            {
-                ProcessCustomer(FrontCustomer);
-            }
-            else
-            {
-                DebugLog(FString::Printf(TEXT("Front customer not close enough to queue front. Distance: %f"), DistanceToQueueFront));
-            }
+            Metrics->RecordNavigationFailure(Customer);
         }
-    }
-}
-
-
-void ACheckout::SetCustomerTargetRotation(AAICustomerPawn* Customer, int32 CustomerIndex)
-{
-    if (!Customer || !CheckoutMesh)
+        AssignedQueueSlots.Remove(Customer);
+        GetWorldTimerManager().SetTimer(QueueMoveRetryTimerHandle, this, &ACheckout::RetryQueueMoves, 1.0f, false);
         return;
+    }
 
-    FRotator TargetRotation;
+    SetCustomerTargetRotation(Customer, TargetLocation, LookAtLocation);
+    StartRotationUpdate();
 
-    if (CustomerIndex == 0)
+    if (StationIndex != INDEX_NONE)
     {
-        // Front customer faces the checkout
-        FVector DirectionToCheckout = CheckoutMesh->GetComponentLocation() - Customer->GetActorLocation();
-        DirectionToCheckout.Z = 0; // Ignore height difference
-        TargetRotation = DirectionToCheckout.Rotation();
+        ProcessCustomer(Customer);
     }
-    else if (CustomersInQueue.IsValidIndex(CustomerIndex - 1))
+}
+
+void ACheckout::RetryQueueMoves()
+{
+    // Station customers that never arrived are sent again, waiting customers are picked up by UpdateQueue
+    for (const FCheckoutStation& Station : Stations)
     {
-        // Other customers face the customer in front
-        AAICustomerPawn* CustomerInFront = CustomersInQueue[CustomerIndex - 1];
-        FVector DirectionToFront = CustomerInFront->GetActorLocation() - Customer->GetActorLocation();
-        DirectionToFront.Z = 0; // Ignore height difference
-        TargetRotation = DirectionToFront.Rotation();
+        if (Station.Customer && FVector::Dist(Station.Customer->GetActorLocation(), Station.CustomerPoint->GetComponentLocation()) > ProcessingDistance)
+        {
+            Station.Customer->MoveTo(Station.CustomerPoint->GetComponentLocation());
+        }
     }
 
-    // Store the target rotation for this customer
-    CustomerTargetRotations.Add(Customer, TargetRotation);
+    UpdateQueue();
 }
 
 
-void ACheckout::RemoveScannedItem()
+void ACheckout::SetCustomerTargetRotation(AAICustomerPawn* Customer, const FVector& FromLocation, const FVector& LookAtLocation)
 {
-    if (ItemsOnCounter.Num() > 0)
-    {
-        AProduct* ScannedItem = ItemsOnCounter[0];
-        ItemsOnCounter.RemoveAt(0);
+    if (!Customer)
+        return;
 
-        if (ScannedItem)
-        {
-            ScannedItem->SetActorHiddenInGame(true);
-            ScannedItem->SetActorEnableCollision(false);
+    // Rotations are derived from the fixed checkout spots rather than from where other customers happen to be
+    FVector Direction = LookAtLocation - FromLocation;
+    Direction.Z = 0; // Ignore height difference
 
-            // If the product has a mesh component, make sure it's hidden
-            UStaticMeshComponent* ProductMesh = ScannedItem->FindComponentByClass<UStaticMeshComponent>();
-            if (ProductMesh)
-            {
-                ProductMesh->SetVisibility(false);
-            }
-        }
-    }
+    // Store the target rotation for this customer
+    CustomerTargetRotations.Add(Customer, Direction.Rotation());
 }
 
+
 void ACheckout::UpdateCustomerRotations()
 {
-    bool AllCustomersRotated = true;
+    // Game time since the last update, the timer runs at most once per frame whatever the simulation speed
+    const float Now = GetWorld()->GetTimeSeconds();
+    const float DeltaSeconds = Now - LastRotationUpdateTime;
+    LastRotationUpdateTime = Now;
 
-    for (auto& Pair : CustomerTargetRotations)
+    // Turning in line is cosmetic, when fast-forwarding everyone faces their target right away
+    const bool bSnap = ASupermarketGameState::ShouldSkipCosmeticsIn(GetWorld());
+
+    for (auto It = CustomerTargetRotations.CreateIterator(); It; ++It)
     {
-        AAICustomerPawn* Customer = Pair.Key;
-        FRotator TargetRotation = Pair.Value;
+        AAICustomerPawn* Customer = It.Key();
+        FRotator TargetRotation = It.Value();
 
         if (Customer)
         {
             FRotator CurrentRotation = Customer->GetActorRotation();
-            FRotator NewRotation = FMath::RInterpTo(CurrentRotation, TargetRotation, GetWorld()->GetDeltaSeconds(), RotationSpeed);
+            FRotator NewRotation = bSnap ? TargetRotation : FMath::RInterpTo(CurrentRotation, TargetRotation, DeltaSeconds, RotationSpeed);
             Customer->SetActorRotation(NewRotation);
 
-            // Check if this customer has reached its target rotation
-            if (!NewRotation.Equals(TargetRotation, 1.0f))
+            // Customers that reached their target rotation drop out of the update
+            if (NewRotation.Equals(TargetRotation, 1.0f))
             {
-                AllCustomersRotated = false;
+                It.RemoveCurrent();
             }
         }
+        else
+        {
+            It.RemoveCurrent();
+        }
     }
 
     // If all customers have reached their target rotations, stop the update timer
-    if (AllCustomersRotated)
+    if (CustomerTargetRotations.Num() == 0)
     {
         GetWorld()->GetTimerManager().ClearTimer(RotationUpdateTimerHandle);
     }
@@ -514,57 +802,78 @@ void ACheckout::UpdateCustomerRotations()
 
 void ACheckout::StartRotationUpdate()
 {
-    // Clear any existing rotation update timer
-    GetWorld()->GetTimerManager().ClearTimer(RotationUpdateTimerHandle);
+    // Keep the running timer if there is one, it picks up the new targets on its next step
+    if (GetWorld()->GetTimerManager().IsTimerActive(RotationUpdateTimerHandle))
+    {
+        return;
+    }
 
-    // Start a new timer to update rotations smoothly
-    GetWorld()->GetTimerManager().SetTimer(RotationUpdateTimerHandle, this, &ACheckout::UpdateCustomerRotations, 0.016f, true);
+    // Start a new timer to update rotations smoothly. Capped at one call per frame, a dilated frame would
+    // otherwise run it dozens of times with the same positions.
+    FTimerManagerTimerParameters TimerParameters;
+    TimerParameters.bLoop = true;
+    TimerParameters.bMaxOncePerFrame = true;
+    LastRotationUpdateTime = GetWorld()->GetTimeSeconds();
+    GetWorld()->GetTimerManager().SetTimer(RotationUpdateTimerHandle, this, &ACheckout::UpdateCustomerRotations, 0.016f, TimerParameters);
+}
+
+void ACheckout::ResetStation(int32 StationIndex)
+{
+    FCheckoutStation& Station = Stations[StationIndex];
+    Station.Customer = nullptr;
+    Station.ProductsToScan.Empty();
+    Station.ScannedItemCount = 0;
+    Station.TotalCents = 0;
+    Station.ScannedItems.Reset();
+    Station.bIsProcessingCustomer = false;
+    Station.bCustomerArrived = false;
+
+    TArray<AProduct*> ItemsOnCounter;
+    if (Station.Conveyor)
+    {
+        Station.Conveyor->RemoveAllItems(ItemsOnCounter);
+    }
+    for (AProduct* Product : ItemsOnCounter)
+    {
+        ReleaseProduct(Product);
+    }
+
+    DisplayStationTotal(StationIndex, 0.0f);
 }
 
 void ACheckout::ResetCheckout()
 {
     DebugLog(TEXT("Resetting checkout state"));
 
-    for (AAICustomerPawn* Customer : CustomersInQueue)
+    // LeaveCheckout calls back into CustomerLeft, so empty the queue and stations before sending anyone away
+    TArray<AAICustomerPawn*> LeavingCustomers = MoveTemp(CustomersInQueue);
+    CustomersInQueue.Empty();
+    NetQueueLength = 0;
+    for (int32 StationIndex = 0; StationIndex < Stations.Num(); ++StationIndex)
     {
-        if (Customer)
-        {
-            Customer->LeaveCheckout();
-        }
+        LeavingCustomers.Add(Stations[StationIndex].Customer);
+        ResetStation(StationIndex);
     }
-    CustomersInQueue.Empty();
+
     // Clear the rotation data
     CustomerTargetRotations.Empty();
+    AssignedQueueSlots.Empty();
     GetWorld()->GetTimerManager().ClearTimer(RotationUpdateTimerHandle);
-    ScannedItems.Empty();
-    ProductsToScan.Empty();
-    CurrentItemIndex = 0;
-    TotalAmount = 0.0f;
-    bIsProcessingCustomer = false;
-
-    GetWorldTimerManager().ClearTimer(ScanItemTimerHandle);
-    GetWorldTimerManager().ClearTimer(UpdateQueueTimerHandle);
-    GetWorldTimerManager().ClearTimer(MoveItemTimerHandle);
+    GetWorldTimerManager().ClearTimer(QueueMoveRetryTimerHandle);
 
-    for (AProduct* Product : ItemsOnCounter)
+    for (AAICustomerPawn* Customer : LeavingCustomers)
     {
-        if (Product)
+        if (Customer)
         {
-            Product->SetActorHiddenInGame(true);
-            Product->SetActorEnableCollision(false);
+            Customer->LeaveCheckout();
         }
     }
-    ItemsOnCounter.Empty();
-
-    DisplayTotal(0.0f);
 
     if (CheckoutMesh)
     {
         CheckoutMesh->Stop();
     }
 
-    SetupUpdateQueueTimer();
-
     DebugLog(TEXT("Checkout reset complete"));
     DebugLogQueueState();
 }
@@ -572,7 +881,11 @@ void ACheckout::ResetCheckout()
 void ACheckout::DebugLogQueueState()
 {
     DebugLog(TEXT("Current Queue State:"));
-    DebugLog(FString::Printf(TEXT("Queue Size: %d, Max Queue Size: %d"), CustomersInQueue.Num(), MaxQueueSize));
+    DebugLog(FString::Printf(TEXT("Queue Size: %d, Max Queue Size: %d, Stations: %d"), CustomersInQueue.Num(), MaxQueueSize, Stations.Num()));
+    for (int32 i = 0; i < Stations.Num(); ++i)
+    {
+        DebugLog(FString::Printf(TEXT("Station %d: %s"), i, Stations[i].Customer ? *Stations[i].Customer->GetName() : TEXT("free")));
+    }
     for (int32 i = 0; i < CustomersInQueue.Num(); ++i)
     {
         DebugLog(FString::Printf(TEXT("Customer %d: %s"), i, *CustomersInQueue[i]->GetName()));
@@ -582,9 +895,12 @@ void ACheckout::DebugLogQueueState()
 void ACheckout::DebugLogScanState()
 {
     DebugLog(TEXT("Current Scan State:"));
-    DebugLog(FString::Printf(TEXT("Total Products to Scan: %d, Current Index: %d"), ProductsToScan.Num(), CurrentItemIndex));
-    DebugLog(FString::Printf(TEXT("Scanned Items: %d, Total Amount: %.2f"), ScannedItems.Num(), TotalAmount));
-    DebugLog(FString::Printf(TEXT("Items on Counter: %d"), ItemsOnCounter.Num()));
+    for (int32 i = 0; i < Stations.Num(); ++i)
+    {
+        const FCheckoutStation& Station = Stations[i];
+        DebugLog(FString::Printf(TEXT("Station %d - Products to Scan: %d, Scanned Items: %d, Total Amount: %.2f, Items on Counter: %d"),
+            i, Station.ProductsToScan.Num(), Station.ScannedItemCount, Station.TotalCents / 100.0f, Station.Conveyor ? Station.Conveyor->GetNumItems() : 0));
+    }
 }
 
 void ACheckout::DebugLog(const FString& Message)
@@ -598,3 +914,22 @@ void ACheckout::DebugLog(const FString& Message)
     }
 }
 
+void ACheckout::OnRep_StationTotals()
+{
+    // Stations are set up the same way on clients, only the amounts come from the server
+    for (int32 StationIndex = 0; StationIndex < StationTotals.Num() && StationIndex < Stations.Num(); ++StationIndex)
+    {
+        if (Stations[StationIndex].TotalText)
+        {
+            Stations[StationIndex].TotalText->SetText(FText::FromString(FString::Printf(TEXT("Total: $%.2f"), StationTotals[StationIndex])));
+        }
+    }
+}
+
+void ACheckout::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(ACheckout, StationTotals);
+    DOREPLIFETIME(ACheckout, NetQueueLength);
+}
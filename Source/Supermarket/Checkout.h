@@ -3,6 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "SupermarketGameState.h"
 #include "Checkout.generated.h"
 class USceneComponent;
 class AAICustomerPawn;
@@ -12,6 +13,79 @@ class UAnimMontage;
 class UStaticMeshComponent;
 class UTextRenderComponent;
 class UAudioComponent;
+class UCheckoutConveyorComponent;
+
+// Throughput of one checkout lane, used to compare serial and pipelined processing
+USTRUCT(BlueprintType)
+struct FCheckoutThroughputStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Checkout")
+    int32 CustomersServed = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Checkout")
+    int32 ItemsScanned = 0;
+
+    // World time at which the first transaction of this lane started, negative until then
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Checkout")
+    float FirstTransactionStartTime = -1.0f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Checkout")
+    float LastTransactionEndTime = 0.0f;
+
+    // Sum of the time between starting to unload a basket and finishing its payment
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Checkout")
+    float TotalTransactionTime = 0.0f;
+};
+
+// One scanning station of a checkout: its counter grid, scanner, total display and the transaction in progress.
+// Kept as plain data so a single ACheckout can drive any number of stations off one shared queue.
+USTRUCT()
+struct FCheckoutStation
+{
+    GENERATED_BODY()
+
+    // Where the customer being served stands
+    UPROPERTY()
+    USceneComponent* CustomerPoint = nullptr;
+
+    UPROPERTY()
+    USceneComponent* GridStartPoint = nullptr;
+
+    UPROPERTY()
+    USceneComponent* ScanPoint = nullptr;
+
+    UPROPERTY()
+    UTextRenderComponent* TotalText = nullptr;
+
+    UPROPERTY()
+    UCheckoutConveyorComponent* Conveyor = nullptr;
+
+    // Customer assigned to this station, set as soon as they leave the waiting queue
+    UPROPERTY()
+    AAICustomerPawn* Customer = nullptr;
+
+    UPROPERTY()
+    TArray<AProduct*> ProductsToScan;
+
+    int32 ScannedItemCount = 0;
+    int64 TotalCents = 0;
+
+    // Quantity and money scanned per SKU, handed to the ledger when the transaction finishes
+    UPROPERTY()
+    TArray<FSkuCount> ScannedItems;
+
+    float TransactionStartTime = 0.0f;
+    bool bIsProcessingCustomer = false;
+
+    // Set once the customer stands at CustomerPoint. A pipelined basket can be staged and scanned before that,
+    // payment always waits for it.
+    bool bCustomerArrived = false;
+
+    UPROPERTY()
+    FCheckoutThroughputStats ThroughputStats;
+};
 
 UCLASS()
 class SUPERMARKET_API ACheckout : public AActor
@@ -38,6 +112,9 @@ public:
     UFUNCTION(BlueprintCallable)
     void CustomerLeft(AAICustomerPawn* Customer);
 
+    // Called by a queued customer when its move towards the assigned queue slot has finished
+    void NotifyCustomerMoveCompleted(AAICustomerPawn* Customer, bool bSuccess);
+
     UFUNCTION(BlueprintCallable)
     bool ProcessPayment(float Amount);
 
@@ -47,6 +124,37 @@ public:
     UFUNCTION(BlueprintCallable)
     void ResetCheckout();
 
+    // Combined over all stations of this checkout
+    UFUNCTION(BlueprintCallable, Category = "Checkout")
+    float GetCustomersPerHour() const;
+
+    // Combined over all stations of this checkout
+    UFUNCTION(BlueprintCallable, Category = "Checkout")
+    FCheckoutThroughputStats GetThroughputStats() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Checkout")
+    int32 GetNumStations() const { return Stations.Num(); }
+
+    // Customers waiting for a free station, replicated so clients can show it
+    UFUNCTION(BlueprintCallable, Category = "Checkout")
+    int32 GetQueueLength() const { return HasAuthority() ? CustomersInQueue.Num() : NetQueueLength; }
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    // Number of scanning stations sharing this checkout's queue. Station 0 uses the components below,
+    // the others are copies of them shifted by StationOffset.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Checkout", meta = (ClampMin = "1"))
+    int32 NumStations = 1;
+
+    // Offset between neighbouring stations, in the checkout's local space
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Checkout")
+    FVector StationOffset = FVector(0.0f, 150.0f, 0.0f);
+
+    // When set, the next customer's basket is staged onto the counter as soon as the current customer starts paying,
+    // instead of waiting for that customer to leave and the next one to walk up to the front
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Checkout")
+    bool bPipelinedCheckout = false;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Checkout")
     USceneComponent* GridStartPoint;
 
@@ -71,6 +179,9 @@ protected:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Audio")
     UAudioComponent* PaymentSound;
 
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Checkout")
+    UCheckoutConveyorComponent* Conveyor;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Animation")
     UAnimMontage* ScanItemAnimation;
 
@@ -81,33 +192,40 @@ protected:
     UPROPERTY(EditAnywhere, Category = "Queue")
     TArray<USceneComponent*> QueuePositions;
 private:
-    UPROPERTY()
-    TArray<AProduct*> ScannedItems;
     UPROPERTY(EditAnywhere, Category = "Queue", meta = (ClampMin = "0.1", ClampMax = "10.0"))
     float RotationSpeed = 10.0f;
     TMap<AAICustomerPawn*, FRotator> CustomerTargetRotations;
+    // Queue slot each customer was last sent to, so only customers whose slot changed get a new move
+    TMap<AAICustomerPawn*, int32> AssignedQueueSlots;
     FTimerHandle RotationUpdateTimerHandle;
-    void SetCustomerTargetRotation(AAICustomerPawn* Customer, int32 CustomerIndex);
+    float LastRotationUpdateTime = 0.0f;
+    FTimerHandle QueueMoveRetryTimerHandle;
+    void SetCustomerTargetRotation(AAICustomerPawn* Customer, const FVector& FromLocation, const FVector& LookAtLocation);
     void StartRotationUpdate();
     void UpdateCustomerRotations();
     UPROPERTY()
-    TArray<AProduct*> ProductsToScan;
-
-    UPROPERTY()
-    TArray<AProduct*> ItemsOnCounter;
-
-    float TotalAmount;
-    int32 CurrentItemIndex;
-    bool bIsProcessingCustomer;
+    TArray<FCheckoutStation> Stations;
 
     UPROPERTY(EditAnywhere, Category = "Checkout")
     float ProcessingDistance = 100.0f;
 
 
 
+    // Customers waiting for a free station. Waiting customer i stands on QueuePositions[i + 1],
+    // QueuePositions[0] is where station 0 serves its customer.
     UPROPERTY()
     TArray<AAICustomerPawn*> CustomersInQueue;
 
+    // Checkout state sent to clients, the stations themselves only exist on the server
+    UPROPERTY(ReplicatedUsing = OnRep_StationTotals)
+    TArray<float> StationTotals;
+
+    UPROPERTY(Replicated)
+    int32 NetQueueLength = 0;
+
+    UFUNCTION()
+    void OnRep_StationTotals();
+
  
 
     UPROPERTY(EditAnywhere, Category = "Display")
@@ -131,19 +249,27 @@ private:
     UPROPERTY(EditAnywhere, Category = "Checkout", meta = (AllowPrivateAccess = "true"))
     FVector ItemStandingRotation = FVector(0.0f, 0.0f, 90.0f);
 
-    FTimerHandle ScanItemTimerHandle;
-    FTimerHandle UpdateQueueTimerHandle;
-    FTimerHandle MoveItemTimerHandle;
-
-    void SetupUpdateQueueTimer();
+    void SetupStations();
+    USceneComponent* CreateStationComponent(USceneComponent* NewComponent, USceneComponent* Template, int32 StationIndex);
+    int32 FindStationOfCustomer(const AAICustomerPawn* Customer) const;
+    void DispatchWaitingCustomers();
     void UpdateQueue();
-    void PlaceItemsOnCounter();
-    void MoveNextItemToScanPosition();
-    void RemoveScannedItem();
+    void RetryQueueMoves();
+    void BeginTransaction(int32 StationIndex);
+    void PlaceItemsOnCounter(FCheckoutStation& Station);
+    void ScanStationItem(int32 StationIndex, AProduct* Product);
+    void FinishStationTransaction(int32 StationIndex);
+    void DisplayStationTotal(int32 StationIndex, float Amount);
+    void ResetStation(int32 StationIndex);
+    void HandleItemScanned(AProduct* Product, int32 StationIndex);
+
+    // True while the payment animation plays on the shared checkout mesh
+    bool IsPaymentAnimationPlaying() const;
+
+    // Hands a product that left the counter back to the product pool
+    void ReleaseProduct(AProduct* Product);
+    void HandleConveyorEmptied(int32 StationIndex);
     void DebugLogQueueState();
     void DebugLogScanState();
     void DebugLog(const FString& Message);
-
-    UFUNCTION()
-    void UpdateItemPosition(AProduct* Item, FVector StartLocation, FVector EndLocation, float ElapsedTime, float Duration);
 };
\ No newline at end of file
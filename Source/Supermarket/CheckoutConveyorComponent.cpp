@@ -0,0 +1,187 @@
+// CheckoutConveyorComponent.cpp
+#include "CheckoutConveyorComponent.h"
+#include "Product.h"
+#include "SupermarketGameState.h"
+#include "Components/StaticMeshComponent.h"
+
+UCheckoutConveyorComponent::UCheckoutConveyorComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
+
+    ItemSpeed = 300.0f;
+    ItemSpacing = 20.0f;
+    ScanInterval = 0.2f;
+
+    Head = 0;
+    NumItems = 0;
+    ScanCooldown = 0.0f;
+    ScanLocation = FVector::ZeroVector;
+    LaneDirection = FVector::ForwardVector;
+
+    // Room for a full counter grid before the ring has to grow
+    Items.SetNum(24);
+}
+
+void UCheckoutConveyorComponent::SetLane(const FVector& InScanLocation, const FVector& InLaneDirection)
+{
+    ScanLocation = InScanLocation;
+    LaneDirection = InLaneDirection.GetSafeNormal();
+    if (LaneDirection.IsNearlyZero())
+    {
+        LaneDirection = FVector::ForwardVector;
+    }
+}
+
+FVector UCheckoutConveyorComponent::GetSlotLocation(int32 LaneIndex, float BottomOffset) const
+{
+    return ScanLocation - LaneDirection * (LaneIndex * ItemSpacing) + FVector(0.0f, 0.0f, BottomOffset);
+}
+
+void UCheckoutConveyorComponent::AddItem(AProduct* Product)
+{
+    if (!Product)
+    {
+        return;
+    }
+
+    if (NumItems == Items.Num())
+    {
+        Grow();
+    }
+
+    FConveyorItem& NewItem = GetItem(NumItems);
+    NewItem.Product = Product;
+    NewItem.Location = Product->GetActorLocation();
+    NewItem.BottomOffset = Product->ProductMesh ? Product->ProductMesh->Bounds.BoxExtent.Z : 0.0f;
+    NewItem.bSettled = false;
+    ++NumItems;
+
+    SetComponentTickEnabled(true);
+}
+
+void UCheckoutConveyorComponent::RemoveAllItems(TArray<AProduct*>& OutProducts)
+{
+    OutProducts.Reserve(OutProducts.Num() + NumItems);
+    for (int32 LaneIndex = 0; LaneIndex < NumItems; ++LaneIndex)
+    {
+        FConveyorItem& Item = GetItem(LaneIndex);
+        OutProducts.Add(Item.Product);
+        Item = FConveyorItem();
+    }
+
+    Head = 0;
+    NumItems = 0;
+    ScanCooldown = 0.0f;
+    SetComponentTickEnabled(false);
+}
+
+bool UCheckoutConveyorComponent::ScanFrontItem()
+{
+    if (NumItems == 0 || !GetItem(0).bSettled)
+    {
+        return false;
+    }
+
+    PopFrontItem();
+    return true;
+}
+
+void UCheckoutConveyorComponent::DelayNextScan(float Seconds)
+{
+    ScanCooldown = FMath::Max(ScanCooldown, Seconds);
+}
+
+void UCheckoutConveyorComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    // When fast-forwarding, items jump straight to their slot and the scanner catches up on every scan
+    // it would have made during the frame, so throughput doesn't depend on the frame rate
+    const bool bSnapItems = ASupermarketGameState::ShouldSkipCosmeticsIn(GetWorld());
+
+    ScanCooldown -= DeltaTime;
+    AdvanceItems(DeltaTime, bSnapItems);
+
+    while (NumItems > 0 && GetItem(0).bSettled && ScanCooldown <= 0.0f)
+    {
+        PopFrontItem();
+        if (bSnapItems)
+        {
+            AdvanceItems(DeltaTime, true);
+        }
+    }
+
+    // Time left over while the front item was still travelling isn't banked for later scans
+    ScanCooldown = FMath::Max(ScanCooldown, 0.0f);
+
+    if (NumItems == 0 && ScanCooldown <= 0.0f)
+    {
+        SetComponentTickEnabled(false);
+    }
+}
+
+void UCheckoutConveyorComponent::AdvanceItems(float DeltaTime, bool bSnap)
+{
+    // Advance every moving item towards its slot in one pass
+    for (int32 LaneIndex = 0; LaneIndex < NumItems; ++LaneIndex)
+    {
+        FConveyorItem& Item = GetItem(LaneIndex);
+        if (Item.bSettled)
+        {
+            continue;
+        }
+
+        const FVector Target = GetSlotLocation(LaneIndex, Item.BottomOffset);
+        Item.Location = bSnap ? Target : FMath::VInterpConstantTo(Item.Location, Target, DeltaTime, ItemSpeed);
+        Item.bSettled = Item.Location.Equals(Target, 0.1f);
+
+        if (Item.Product)
+        {
+            Item.Product->SetActorLocation(Item.Location);
+        }
+    }
+}
+
+void UCheckoutConveyorComponent::PopFrontItem()
+{
+    FConveyorItem& FrontItem = GetItem(0);
+    AProduct* ScannedProduct = FrontItem.Product;
+    FrontItem = FConveyorItem();
+
+    Head = (Head + 1) % Items.Num();
+    --NumItems;
+
+    // Keeps any overshoot from a long frame so back-to-back scans stay ScanInterval apart in game time
+    ScanCooldown = FMath::Min(ScanCooldown, 0.0f) + ScanInterval;
+
+    // Everything behind the scanned item moves up one slot
+    for (int32 LaneIndex = 0; LaneIndex < NumItems; ++LaneIndex)
+    {
+        GetItem(LaneIndex).bSettled = false;
+    }
+
+    if (ScannedProduct)
+    {
+        OnItemScanned.Broadcast(ScannedProduct);
+    }
+
+    if (NumItems == 0)
+    {
+        OnEmptied.Broadcast();
+    }
+}
+
+void UCheckoutConveyorComponent::Grow()
+{
+    // Unroll the ring into lane order so Head can start over at zero
+    TArray<FConveyorItem> Grown;
+    Grown.SetNum(FMath::Max(Items.Num() * 2, 8));
+    for (int32 LaneIndex = 0; LaneIndex < NumItems; ++LaneIndex)
+    {
+        Grown[LaneIndex] = GetItem(LaneIndex);
+    }
+
+    Items = MoveTemp(Grown);
+    Head = 0;
+}
@@ -0,0 +1,95 @@
+// CheckoutConveyorComponent.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "CheckoutConveyorComponent.generated.h"
+
+class AProduct;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnConveyorItemScanned, AProduct* /*Product*/);
+DECLARE_MULTICAST_DELEGATE(FOnConveyorEmptied);
+
+USTRUCT()
+struct FConveyorItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    AProduct* Product = nullptr;
+
+    FVector Location = FVector::ZeroVector;
+
+    // Half height of the product, so its bottom sits on the lane
+    float BottomOffset = 0.0f;
+
+    // Settled items are at their lane slot and are skipped until the lane shifts again
+    bool bSettled = false;
+};
+
+// Belt that owns the items on a checkout counter. Items are kept in a ring buffer in lane order
+// and all of them advance in a single native tick towards their slot in front of the scan point.
+// Whenever the front item reaches the scanner it is popped and handed out through OnItemScanned.
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SUPERMARKET_API UCheckoutConveyorComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UCheckoutConveyorComponent();
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    // Precomputes the lane. Slot 0 is at ScanLocation, the following slots line up behind it against LaneDirection.
+    void SetLane(const FVector& InScanLocation, const FVector& InLaneDirection);
+
+    // Puts a product at the back of the lane. It travels from wherever it currently is.
+    void AddItem(AProduct* Product);
+
+    // Removes every item without scanning it
+    void RemoveAllItems(TArray<AProduct*>& OutProducts);
+
+    // Scans the front item right away if it has reached the scanner, ignoring the scan interval
+    bool ScanFrontItem();
+
+    // Holds the scanner for the given time, items keep moving up meanwhile
+    void DelayNextScan(float Seconds);
+
+    UFUNCTION(BlueprintCallable, Category = "Conveyor")
+    int32 GetNumItems() const { return NumItems; }
+
+    UFUNCTION(BlueprintCallable, Category = "Conveyor")
+    bool IsEmpty() const { return NumItems == 0; }
+
+    // Fired when an item is taken off the lane by the scanner
+    FOnConveyorItemScanned OnItemScanned;
+
+    // Fired when the last item has been scanned
+    FOnConveyorEmptied OnEmptied;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Conveyor")
+    float ItemSpeed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Conveyor")
+    float ItemSpacing;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Conveyor")
+    float ScanInterval;
+
+private:
+    UPROPERTY()
+    TArray<FConveyorItem> Items;
+
+    int32 Head;
+    int32 NumItems;
+    float ScanCooldown;
+
+    FVector ScanLocation;
+    FVector LaneDirection;
+
+    FConveyorItem& GetItem(int32 LaneIndex) { return Items[(Head + LaneIndex) % Items.Num()]; }
+    FVector GetSlotLocation(int32 LaneIndex, float BottomOffset) const;
+    void AdvanceItems(float DeltaTime, bool bSnap);
+    void PopFrontItem();
+    void Grow();
+};
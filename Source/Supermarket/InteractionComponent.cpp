@@ -0,0 +1,155 @@
+// InteractionComponent.cpp
+#include "InteractionComponent.h"
+#include "Supermarket.h"
+#include "Components/PrimitiveComponent.h"
+
+UInteractionComponent::UInteractionComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+
+    TraceDistance = 300.0f;
+    AcquireTraceCount = 2;
+    LoseFocusDelay = 0.15f;
+    bHighlightFocus = true;
+
+    TraceOrigin = nullptr;
+    CandidateHits = 0;
+    TimeSinceFocusHit = 0.0f;
+
+    TraceDelegate.BindUObject(this, &UInteractionComponent::OnTraceCompleted);
+}
+
+void UInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    SetFocus(nullptr);
+    PendingTrace = FTraceHandle();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    TimeSinceFocusHit += DeltaTime;
+
+    // Last frame's trace is still running, its result arrives through OnTraceCompleted
+    UWorld* World = GetWorld();
+    if (PendingTrace.IsValid() && !World->IsTraceHandleValid(PendingTrace, false))
+    {
+        PendingTrace = FTraceHandle();
+    }
+    if (PendingTrace.IsValid())
+    {
+        return;
+    }
+
+    FVector Start;
+    FVector Direction;
+    if (TraceOrigin)
+    {
+        Start = TraceOrigin->GetComponentLocation();
+        Direction = TraceOrigin->GetForwardVector();
+    }
+    else
+    {
+        FRotator EyesRotation;
+        GetOwner()->GetActorEyesViewPoint(Start, EyesRotation);
+        Direction = EyesRotation.Vector();
+    }
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(InteractionTrace), false, GetOwner());
+    IgnoredActors.RemoveAllSwap([](const TWeakObjectPtr<AActor>& IgnoredActor) { return !IgnoredActor.IsValid(); });
+    for (const TWeakObjectPtr<AActor>& IgnoredActor : IgnoredActors)
+    {
+        QueryParams.AddIgnoredActor(IgnoredActor.Get());
+    }
+    PendingTrace = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, Start + Direction * TraceDistance,
+        ECC_Interactable, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate);
+}
+
+void UInteractionComponent::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    PendingTrace = FTraceHandle();
+
+    AActor* HitActor = Datum.OutHits.Num() > 0 ? Datum.OutHits[0].GetActor() : nullptr;
+
+    if (HitActor && HitActor == FocusActor.Get())
+    {
+        FocusHit = Datum.OutHits[0];
+        TimeSinceFocusHit = 0.0f;
+        CandidateActor.Reset();
+        CandidateHits = 0;
+        return;
+    }
+
+    // A different actor has to be hit several traces in a row before it takes the focus
+    if (HitActor)
+    {
+        if (HitActor == CandidateActor.Get())
+        {
+            ++CandidateHits;
+        }
+        else
+        {
+            CandidateActor = HitActor;
+            CandidateHits = 1;
+        }
+
+        if (CandidateHits >= AcquireTraceCount)
+        {
+            FocusHit = Datum.OutHits[0];
+            SetFocus(HitActor);
+            return;
+        }
+    }
+    else
+    {
+        CandidateActor.Reset();
+        CandidateHits = 0;
+    }
+
+    // The current focus survives brief misses, e.g. while looking across a gap between shelves
+    if (FocusActor.IsValid() && TimeSinceFocusHit >= LoseFocusDelay)
+    {
+        SetFocus(nullptr);
+    }
+}
+
+void UInteractionComponent::SetFocus(AActor* NewFocus)
+{
+    AActor* OldFocus = FocusActor.Get();
+    TimeSinceFocusHit = 0.0f;
+    CandidateActor.Reset();
+    CandidateHits = 0;
+
+    if (OldFocus == NewFocus)
+    {
+        return;
+    }
+
+    if (bHighlightFocus)
+    {
+        SetHighlighted(OldFocus, false);
+        SetHighlighted(NewFocus, true);
+    }
+
+    FocusActor = NewFocus;
+    OnFocusChanged.Broadcast(OldFocus, NewFocus);
+}
+
+void UInteractionComponent::SetHighlighted(AActor* Actor, bool bHighlighted) const
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    Actor->ForEachComponent<UPrimitiveComponent>(false, [bHighlighted](UPrimitiveComponent* Primitive)
+    {
+        if (Primitive->GetCollisionResponseToChannel(ECC_Interactable) == ECR_Block)
+        {
+            Primitive->SetRenderCustomDepth(bHighlighted);
+        }
+    });
+}
@@ -0,0 +1,78 @@
+// InteractionComponent.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "InteractionComponent.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnInteractionFocusChanged, AActor* /*OldFocus*/, AActor* /*NewFocus*/);
+
+// Works out what the player is looking at. Every frame it issues one asynchronous line trace on the
+// Interactable channel and reads the result of the previous frame's trace, so there is never a blocking
+// trace on the game thread. The result is kept as a focus target with hysteresis: a new actor has to be
+// hit on AcquireTraceCount traces in a row to take focus, and focus is only dropped after LoseFocusDelay
+// seconds without a hit. Stocking, interacting and highlighting all read the same focus.
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SUPERMARKET_API UInteractionComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UInteractionComponent();
+
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    // Traces are cast from this component along its forward vector, the owner's eyes are used when unset
+    void SetTraceOrigin(USceneComponent* InTraceOrigin) { TraceOrigin = InTraceOrigin; }
+
+    // Actors the trace passes through besides the owner, e.g. the box the player is carrying
+    void AddIgnoredActor(AActor* Actor) { IgnoredActors.AddUnique(Actor); }
+    void RemoveIgnoredActor(AActor* Actor) { IgnoredActors.Remove(Actor); }
+
+    UFUNCTION(BlueprintCallable, Category = "Interaction")
+    AActor* GetFocusActor() const { return FocusActor.Get(); }
+
+    template <typename T>
+    T* GetFocus() const { return Cast<T>(FocusActor.Get()); }
+
+    // Latest trace hit on the focus actor, e.g. for the instance index of an instanced mesh
+    const FHitResult& GetFocusHit() const { return FocusHit; }
+
+    FOnInteractionFocusChanged OnFocusChanged;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+    float TraceDistance;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction", meta = (ClampMin = "1"))
+    int32 AcquireTraceCount;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction", meta = (ClampMin = "0.0"))
+    float LoseFocusDelay;
+
+    // Draws the focused actor into the custom depth buffer for an outline post process
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+    bool bHighlightFocus;
+
+protected:
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+    void SetFocus(AActor* NewFocus);
+    void SetHighlighted(AActor* Actor, bool bHighlighted) const;
+
+    UPROPERTY()
+    USceneComponent* TraceOrigin;
+
+    TArray<TWeakObjectPtr<AActor>> IgnoredActors;
+
+    TWeakObjectPtr<AActor> FocusActor;
+    FHitResult FocusHit;
+    TWeakObjectPtr<AActor> CandidateActor;
+    int32 CandidateHits;
+    float TimeSinceFocusHit;
+
+    FTraceDelegate TraceDelegate;
+    FTraceHandle PendingTrace;
+};
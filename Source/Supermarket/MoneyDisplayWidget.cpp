@@ -1,15 +1,58 @@
 // MoneyDisplayWidget.cpp
 #include "MoneyDisplayWidget.h"
 #include "Components/TextBlock.h"
+#include "Components/InvalidationBox.h"
+#include "Components/PanelWidget.h"
+#include "Blueprint/WidgetTree.h"
 #include "SupermarketGameState.h"
 #include "Kismet/GameplayStatics.h"
 
+void UMoneyDisplayWidget::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    // Wrap the text in an invalidation box so the cached widget is reused between sales
+    if (!MoneyInvalidationBox && MoneyText && WidgetTree)
+    {
+        UPanelWidget* Parent = MoneyText->GetParent();
+        MoneyInvalidationBox = WidgetTree->ConstructWidget<UInvalidationBox>(UInvalidationBox::StaticClass(), TEXT("MoneyInvalidationBox"));
+
+        if (Parent && Parent->ReplaceChild(MoneyText, MoneyInvalidationBox))
+        {
+            MoneyInvalidationBox->AddChild(MoneyText);
+        }
+        else if (WidgetTree->RootWidget == MoneyText)
+        {
+            WidgetTree->RootWidget = MoneyInvalidationBox;
+            MoneyInvalidationBox->AddChild(MoneyText);
+        }
+    }
+
+    if (MoneyInvalidationBox)
+    {
+        MoneyInvalidationBox->SetCanCache(true);
+    }
+}
+
 void UMoneyDisplayWidget::NativeConstruct()
 {
     Super::NativeConstruct();
 
-    // Set up a timer to update the display periodically
-    GetWorld()->GetTimerManager().SetTimer(UpdateTimerHandle, this, &UMoneyDisplayWidget::UpdateMoneyDisplayFromGameState, 0.1f, true);
+    TryBindToGameState();
+}
+
+void UMoneyDisplayWidget::NativeDestruct()
+{
+    GetWorld()->GetTimerManager().ClearTimer(BindRetryTimerHandle);
+
+    if (ASupermarketGameState* GameState = BoundGameState.Get())
+    {
+        GameState->OnMoneyChanged.Remove(MoneyChangedHandle);
+    }
+    BoundGameState.Reset();
+    MoneyChangedHandle.Reset();
+
+    Super::NativeDestruct();
 }
 
 void UMoneyDisplayWidget::UpdateMoneyDisplay(float NewAmount)
@@ -21,10 +64,29 @@ void UMoneyDisplayWidget::UpdateMoneyDisplay(float NewAmount)
     }
 }
 
-void UMoneyDisplayWidget::UpdateMoneyDisplayFromGameState()
+void UMoneyDisplayWidget::TryBindToGameState()
 {
-    if (ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>())
+    if (BoundGameState.IsValid())
+    {
+        return;
+    }
+
+    ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+    if (!GameState)
     {
-        UpdateMoneyDisplay(GameState->GetTotalMoney());
+        // On clients the game state can replicate in after the widget is shown, check again shortly
+        GetWorld()->GetTimerManager().SetTimer(BindRetryTimerHandle, this, &UMoneyDisplayWidget::TryBindToGameState, 0.1f, false);
+        return;
     }
-}
\ No newline at end of file
+
+    BoundGameState = GameState;
+    MoneyChangedHandle = GameState->OnMoneyChanged.AddUObject(this, &UMoneyDisplayWidget::HandleMoneyChanged);
+
+    // Show the current balance once, after that the text only changes when money does
+    UpdateMoneyDisplay(GameState->GetTotalMoney());
+}
+
+void UMoneyDisplayWidget::HandleMoneyChanged(float NewTotalMoney)
+{
+    UpdateMoneyDisplay(NewTotalMoney);
+}
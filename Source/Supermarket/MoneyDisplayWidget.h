@@ -5,6 +5,8 @@
 #include "Blueprint/UserWidget.h"
 #include "MoneyDisplayWidget.generated.h"
 
+class ASupermarketGameState;
+
 UCLASS()
 class SUPERMARKET_API UMoneyDisplayWidget : public UUserWidget
 {
@@ -15,12 +17,23 @@ public:
     void UpdateMoneyDisplay(float NewAmount);
 
 protected:
+    virtual void NativeOnInitialized() override;
     virtual void NativeConstruct() override;
+    virtual void NativeDestruct() override;
 
     UPROPERTY(meta = (BindWidget))
     class UTextBlock* MoneyText;
 
+    // Caches the money text so it is only repainted when the amount changes.
+    // Created around MoneyText at runtime when the widget blueprint doesn't have one.
+    UPROPERTY(meta = (BindWidgetOptional))
+    class UInvalidationBox* MoneyInvalidationBox;
+
 private:
-    void UpdateMoneyDisplayFromGameState();
-    FTimerHandle UpdateTimerHandle;
-};
\ No newline at end of file
+    void TryBindToGameState();
+    void HandleMoneyChanged(float NewTotalMoney);
+
+    TWeakObjectPtr<ASupermarketGameState> BoundGameState;
+    FDelegateHandle MoneyChangedHandle;
+    FTimerHandle BindRetryTimerHandle;
+};
@@ -1,6 +1,7 @@
 // Product.cpp
 #include "Product.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Engine/CollisionProfile.h"
 
 AProduct::AProduct()
 {
@@ -9,6 +10,11 @@ AProduct::AProduct()
     ProductMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ProductMesh"));
     RootComponent = ProductMesh;
 
+    // Products never need overlap events, and stay out of most traces (see SetProductState)
+    ProductMesh->SetGenerateOverlapEvents(false);
+    ProductMesh->SetCollisionProfileName(TEXT("ProductLoose"));
+    ProductState = EProductState::Loose;
+
     // Load a default static mesh (cube)
     static ConstructorHelpers::FObjectFinder<UStaticMesh> DefaultMeshAsset(TEXT("/Engine/BasicShapes/Cube.Cube"));
     if (DefaultMeshAsset.Succeeded())
@@ -50,6 +56,37 @@ FProductData AProduct::GetProductData() const
     return ProductData;
 }
 
+FName AProduct::GetSKU() const
+{
+    return FName(*ProductData.Name);
+}
+
+void AProduct::SetProductState(EProductState NewState)
+{
+    if (ProductState == NewState)
+    {
+        return;
+    }
+    ProductState = NewState;
+
+    switch (NewState)
+    {
+    case EProductState::Loose:
+        ProductMesh->SetCollisionProfileName(TEXT("ProductLoose"));
+        break;
+    case EProductState::Shelved:
+        ProductMesh->SetCollisionProfileName(TEXT("ProductShelved"));
+        break;
+    case EProductState::Boxed:
+    case EProductState::Bagged:
+        ProductMesh->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+        break;
+    }
+
+    // Without any collision the product drops out of the physics scene entirely
+    SetActorEnableCollision(NewState == EProductState::Loose || NewState == EProductState::Shelved);
+}
+
 #if WITH_EDITOR
 void AProduct::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
@@ -24,6 +24,16 @@ struct FProductData
         : Name(InName), Price(InPrice), Scale(InScale) {}
 };
 
+// Where a product currently is, decides its collision profile
+UENUM(BlueprintType)
+enum class EProductState : uint8
+{
+    Loose,      // In a hand or on a checkout counter: query only, visible to traces
+    Boxed,      // Inside a product box: no collision, the box collides for it
+    Shelved,    // On a shelf: query only, answers Product channel queries only
+    Bagged      // In a shopping bag or scanned: no collision
+};
+
 UCLASS(BlueprintType, Blueprintable)
 class SUPERMARKET_API AProduct : public AActor
 {
@@ -46,13 +56,27 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Product")
     FProductData GetProductData() const;
-  
+
+    // Stock keeping unit, products with the same name are the same article
+    UFUNCTION(BlueprintCallable, Category = "Product")
+    FName GetSKU() const;
+
+    // Switches the collision profile, and actor collision as a whole, to match the new state
+    UFUNCTION(BlueprintCallable, Category = "Product")
+    void SetProductState(EProductState NewState);
+
+    UFUNCTION(BlueprintCallable, Category = "Product")
+    EProductState GetProductState() const { return ProductState; }
+
 
 protected:
     virtual void BeginPlay() override;
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Product")
     FProductData ProductData;
 
+private:
+    EProductState ProductState;
+
 #if WITH_EDITOR
     virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
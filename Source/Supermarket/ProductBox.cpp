@@ -1,21 +1,37 @@
 // ProductBox.cpp
 #include "ProductBox.h"
+#include "Supermarket.h"
 #include "Camera/CameraComponent.h"
 #include "Components/SceneComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "ProductPool.h"
+#include "SupermarketGameState.h"
 
 AProductBox::AProductBox()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // Held boxes follow the camera through attachment, nothing to do per frame
+    PrimaryActorTick.bCanEverTick = false;
 
     BoxMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BoxMesh"));
     RootComponent = BoxMesh;
+    BoxMesh->SetCollisionResponseToChannel(ECC_Interactable, ECR_Block);
 
     ProductSpawnPoint = CreateDefaultSubobject<USceneComponent>(TEXT("ProductSpawnPoint"));
     ProductSpawnPoint->SetupAttachment(RootComponent);
 
+    // All units in the box are instances of this one component, with their real scale regardless of the box's
+    ContentsInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("ContentsInstances"));
+    ContentsInstances->SetupAttachment(ProductSpawnPoint);
+    ContentsInstances->SetUsingAbsoluteScale(true);
+    ContentsInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    ContentsInstances->SetGenerateOverlapEvents(false);
+    ContentsInstances->SetCanEverAffectNavigation(false);
+
     MaxProducts = 20;
     ProductSpacing = FVector(20.0f, 20.0f, 20.0f);
     bIsAttachedToCamera = false;
+    ProductCount = 0;
+    bContentsBuilt = false;
     // Initialize attachment properties
     CameraOffset = FVector(0.0f, 0.0f, 0.0f);
     CameraRotation = FRotator(0.0f, 0.0f, 0.0f);
@@ -25,7 +41,11 @@ void AProductBox::BeginPlay()
 {
     Super::BeginPlay();
 
-    if (ProductClass)
+    if (HasDeferredContents())
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("ProductBox %s: %d products deferred until first use"), *GetName(), ProductCount);
+    }
+    else if (ProductClass)
     {
         FillBox(ProductClass);
     }
@@ -51,135 +71,153 @@ void AProductBox::FillBox(TSubclassOf<AProduct> ProductToFill)
         return;
     }
 
-    // Clear existing products
-    for (AProduct* Product : Products)
+    ProductCount = MaxProducts;
+    ArrangeProducts();
+}
+
+void AProductBox::SetDeferredContents(TSubclassOf<AProduct> ProductToFill, int32 Quantity)
+{
+    SetProductClass(ProductToFill);
+    MaxProducts = FMath::Max(Quantity, 0);
+    ProductCount = ProductToFill ? MaxProducts : 0;
+    bContentsBuilt = false;
+    ContentsInstances->ClearInstances();
+}
+
+void AProductBox::MaterializeContents()
+{
+    if (HasDeferredContents())
     {
-        if (Product)
-        {
-            Product->Destroy();
-        }
+        ArrangeProducts();
     }
-    Products.Empty();
+}
 
-    // Fill the box with new products
-    while (Products.Num() < MaxProducts)
+AProduct* AProductBox::RemoveProduct()
+{
+    TArray<AProduct*> OutProducts;
+    return RemoveProducts(1, OutProducts) > 0 ? OutProducts[0] : nullptr;
+}
+
+int32 AProductBox::RemoveProducts(int32 Count, TArray<AProduct*>& OutProducts)
+{
+    MaterializeContents();
+
+    const int32 NumToRemove = FMath::Clamp(Count, 0, ProductCount);
+    ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+    UProductPool* Pool = GameState ? GameState->GetProductPool() : nullptr;
+    if (NumToRemove == 0 || !Pool)
     {
-        FActorSpawnParameters SpawnParams;
-        SpawnParams.Owner = this;
-        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-        AProduct* NewProduct = GetWorld()->SpawnActor<AProduct>(ProductClass, ProductSpawnPoint->GetComponentLocation(), ProductSpawnPoint->GetComponentRotation(), SpawnParams);
-        if (NewProduct)
+        return 0;
+    }
+
+    // Take from the last instance down, each unit becomes an actor right where its instance was drawn
+    OutProducts.Reserve(OutProducts.Num() + NumToRemove);
+    int32 Removed = 0;
+    for (; Removed < NumToRemove; ++Removed)
+    {
+        const int32 InstanceIndex = ContentsInstances->GetInstanceCount() - 1;
+        FTransform InstanceTransform = GetActorTransform();
+        if (InstanceIndex >= 0)
         {
-            Products.Add(NewProduct);
-            NewProduct->AttachToComponent(ProductSpawnPoint, FAttachmentTransformRules::KeepRelativeTransform);
+            ContentsInstances->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
         }
-        else
+
+        AProduct* Product = Pool->Acquire(ProductClass, InstanceTransform);
+        if (!Product)
         {
-            UE_LOG(LogTemp, Warning, TEXT("Failed to spawn product for ProductBox"));
             break;
         }
+
+        if (InstanceIndex >= 0)
+        {
+            ContentsInstances->RemoveInstance(InstanceIndex);
+        }
+        OutProducts.Add(Product);
     }
+    ProductCount -= Removed;
 
-    ArrangeProducts();
+    return Removed;
 }
 
-AProduct* AProductBox::RemoveProduct()
+int32 AProductBox::DiscardProducts(int32 Count)
 {
-    if (Products.Num() > 0)
+    MaterializeContents();
+
+    const int32 NumToRemove = FMath::Clamp(Count, 0, ProductCount);
+    for (int32 Removed = 0; Removed < NumToRemove; ++Removed)
     {
-        AProduct* RemovedProduct = Products.Last();
-        Products.RemoveAt(Products.Num() - 1);
-        RemovedProduct->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-        return RemovedProduct;
+        const int32 InstanceIndex = ContentsInstances->GetInstanceCount() - 1;
+        if (InstanceIndex >= 0)
+        {
+            ContentsInstances->RemoveInstance(InstanceIndex);
+        }
     }
-    return nullptr;
-}
+    ProductCount -= NumToRemove;
 
+    return NumToRemove;
+}
 
 void AProductBox::ArrangeProducts()
 {
-    if (Products.Num() == 0 || !ProductSpawnPoint)
+    ContentsInstances->ClearInstances();
+    bContentsBuilt = true;
+
+    const AProduct* DefaultProduct = ProductClass ? ProductClass->GetDefaultObject<AProduct>() : nullptr;
+    UStaticMesh* ProductMesh = DefaultProduct && DefaultProduct->ProductMesh ? DefaultProduct->ProductMesh->GetStaticMesh() : nullptr;
+    if (ProductCount == 0 || !ProductMesh)
     {
-        UE_LOG(LogTemp, Warning, TEXT("No products or ProductSpawnPoint is null in ArrangeProducts"));
+        UE_LOG(LogTemp, Warning, TEXT("No products or product mesh in ArrangeProducts for ProductBox %s"), *GetName());
         return;
     }
 
-    // Get the bounds of the first product to use as a reference
-    FVector ProductExtent = FVector::ZeroVector;
-    if (Products[0])
+    if (ContentsInstances->GetStaticMesh() != ProductMesh)
     {
-        UStaticMeshComponent* MeshComponent = Products[0]->FindComponentByClass<UStaticMeshComponent>();
-        if (MeshComponent)
-        {
-            ProductExtent = MeshComponent->Bounds.BoxExtent;
-        }
+        ContentsInstances->SetStaticMesh(ProductMesh);
     }
 
-    // Use the ProductSpawnPoint's location as the starting point
-    FVector SpawnStart = ProductSpawnPoint->GetComponentLocation();
-    FRotator SpawnRotation = ProductSpawnPoint->GetComponentRotation();
+    // Same reference extent as a spawned product, so units taken out keep their place
+    const FVector ProductScale = DefaultProduct->GetProductData().Scale;
+    const FVector ProductExtent = ProductMesh->GetBounds().BoxExtent * ProductScale.GetAbs();
 
-    // Calculate the offset to move the bottom right corner to the spawn point
-    FVector CornerOffset = FVector(+ProductExtent.X, +ProductExtent.Y, +ProductExtent.Z);
+    // Offset to move the bottom right corner of the first product to the spawn point
+    const FVector CornerOffset = ProductExtent;
 
-    UE_LOG(LogTemp, Display, TEXT("Starting product arrangement at %s with rotation %s"),
-        *SpawnStart.ToString(), *SpawnRotation.ToString());
-
-    int32 ProductIndex = 0;
-    for (int32 Z = 0; Z < GridSize.Z && ProductIndex < Products.Num(); ++Z)
+    // Instances are laid out in the spawn point's space, it is the component's parent
+    TArray<FTransform> InstanceTransforms;
+    InstanceTransforms.Reserve(ProductCount);
+    for (int32 Z = 0; Z < GridSize.Z && InstanceTransforms.Num() < ProductCount; ++Z)
     {
-        for (int32 Y = 0; Y < GridSize.Y && ProductIndex < Products.Num(); ++Y)
+        for (int32 Y = 0; Y < GridSize.Y && InstanceTransforms.Num() < ProductCount; ++Y)
         {
-            for (int32 X = 0; X < GridSize.X && ProductIndex < Products.Num(); ++X)
+            for (int32 X = 0; X < GridSize.X && InstanceTransforms.Num() < ProductCount; ++X)
             {
-                FVector Offset = FVector(
+                const FVector Offset = FVector(
                     X * (ProductSpacing.X + 2 * ProductExtent.X),
                     Y * (ProductSpacing.Y + 2 * ProductExtent.Y),
                     Z * (ProductSpacing.Z + 2 * ProductExtent.Z)
                 );
-
-                // Apply the corner offset and the rotation of the ProductSpawnPoint to the offset
-                FVector RotatedOffset = SpawnRotation.RotateVector(Offset + CornerOffset);
-                FVector ProductLocation = SpawnStart + RotatedOffset;
-
-                // Set the world location and rotation of the product
-                Products[ProductIndex]->SetActorLocationAndRotation(ProductLocation, SpawnRotation);
-
-                UE_LOG(LogTemp, Verbose, TEXT("Placed product %d at %s"), ProductIndex, *ProductLocation.ToString());
-
-                ProductIndex++;
+                InstanceTransforms.Emplace(FQuat::Identity, Offset + CornerOffset, ProductScale);
             }
         }
     }
+    ContentsInstances->AddInstances(InstanceTransforms, false);
 
     UE_LOG(LogTemp, Display, TEXT("Arranged %d products in a %s grid with spacing %s"),
-        ProductIndex, *GridSize.ToString(), *ProductSpacing.ToString());
+        InstanceTransforms.Num(), *GridSize.ToString(), *ProductSpacing.ToString());
 }
 
 void AProductBox::AttachToCamera(UCameraComponent* Camera)
 {
     if (Camera)
     {
+        // Picking the box up is the first time anyone sees inside it
+        MaterializeContents();
         AttachedCamera = Camera;
 
-        // Get the root component of the ProductBox
-        USceneComponent* RootComp = GetRootComponent();
-        if (RootComp)
-        {
-            // Detach from any previous parent
-            RootComp->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
-
-            // Calculate the new world location and rotation
-            FVector NewLocation = Camera->GetComponentLocation() + Camera->GetComponentRotation().RotateVector(CameraOffset);
-            FRotator NewRotation = Camera->GetComponentRotation() + CameraRotation;
-
-            // Set the new world transform
-            RootComp->SetWorldLocationAndRotation(NewLocation, NewRotation);
-
-            // Now attach to the camera
-            FAttachmentTransformRules AttachmentRules(EAttachmentRule::KeepWorld, true);
-            RootComp->AttachToComponent(Camera, AttachmentRules);
-        }
+        // Parented to the camera once, from then on the transform hierarchy carries the box and its contents
+        FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, EAttachmentRule::SnapToTarget, EAttachmentRule::KeepWorld, true);
+        GetRootComponent()->AttachToComponent(Camera, AttachmentRules);
+        GetRootComponent()->SetRelativeLocationAndRotation(CameraOffset, CameraRotation);
 
         bIsAttachedToCamera = true;
     }
@@ -192,23 +230,6 @@ void AProductBox::DetachFromCamera()
     AttachedCamera = nullptr;
 }
 
-// Add to Tick function if not already present
-void AProductBox::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
-
-    if (bIsAttachedToCamera && AttachedCamera)
-    {
-        USceneComponent* RootComp = GetRootComponent();
-        if (RootComp)
-        {
-            FVector NewLocation = AttachedCamera->GetComponentLocation() + AttachedCamera->GetComponentRotation().RotateVector(CameraOffset);
-            FRotator NewRotation = AttachedCamera->GetComponentRotation() + CameraRotation;
-            RootComp->SetWorldLocationAndRotation(NewLocation, NewRotation);
-        }
-    }
-}
-
 AProductBox* AProductBox::SpawnProductBox(UObject* WorldContextObject, TSubclassOf<AProductBox> ProductBoxClass, TSubclassOf<AProduct> ProductToSpawn, int32 Quantity, FVector SpawnLocation, FVector Spacing, FIntVector Grid)
 {
     if (!WorldContextObject || !ProductBoxClass || !ProductToSpawn)
@@ -224,32 +245,23 @@ AProductBox* AProductBox::SpawnProductBox(UObject* WorldContextObject, TSubclass
         return nullptr;
     }
 
-    FActorSpawnParameters SpawnParams;
-    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-    AProductBox* NewProductBox = World->SpawnActor<AProductBox>(ProductBoxClass, SpawnLocation, FRotator::ZeroRotator, SpawnParams);
+    // Deferred so the contents are set up before BeginPlay runs, which then leaves them unspawned
+    const FTransform SpawnTransform(FRotator::ZeroRotator, SpawnLocation);
+    AProductBox* NewProductBox = World->SpawnActorDeferred<AProductBox>(ProductBoxClass, SpawnTransform, nullptr, nullptr,
+        ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
 
     if (NewProductBox)
     {
-        NewProductBox->SetProductClass(ProductToSpawn);
-        NewProductBox->MaxProducts = FMath::Clamp(Quantity, 1, Grid.X * Grid.Y * Grid.Z);
         NewProductBox->ProductSpacing = Spacing;
         NewProductBox->GridSize = Grid;
+        NewProductBox->SetDeferredContents(ProductToSpawn, FMath::Clamp(Quantity, 1, Grid.X * Grid.Y * Grid.Z));
 
         if (NewProductBox->BoxMesh)
         {
             NewProductBox->BoxMesh->SetWorldScale3D(FVector(1.0f));
         }
 
-        // Log the ProductSpawnPoint location for debugging
-        if (NewProductBox->ProductSpawnPoint)
-        {
-            FVector SpawnPointWorldLocation = NewProductBox->ProductSpawnPoint->GetComponentLocation();
-            FRotator SpawnPointWorldRotation = NewProductBox->ProductSpawnPoint->GetComponentRotation();
-            UE_LOG(LogTemp, Display, TEXT("ProductSpawnPoint world location: %s, rotation: %s"),
-                *SpawnPointWorldLocation.ToString(), *SpawnPointWorldRotation.ToString());
-        }
-
-        NewProductBox->FillBox(ProductToSpawn);
+        NewProductBox->FinishSpawning(SpawnTransform);
 
         UE_LOG(LogTemp, Display, TEXT("Spawned ProductBox with %d %s at location %s, Spacing: %s, Grid: %s"),
             NewProductBox->GetProductCount(),
@@ -275,6 +287,7 @@ void AProductBox::AttachToComponent(USceneComponent* Parent)
 {
     if (Parent)
     {
+        MaterializeContents();
         USceneComponent* RootComp = GetRootComponent();
         if (RootComp)
         {
@@ -4,8 +4,11 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Product.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "ProductBox.generated.h"
 
+// A box of one product. The units inside are drawn as instances of a single component and only become
+// AProduct actors, taken from the product pool, when they are removed from the box.
 UCLASS()
 class SUPERMARKET_API AProductBox : public AActor
 {
@@ -13,7 +16,6 @@ class SUPERMARKET_API AProductBox : public AActor
 
 public:
     AProductBox();
-    virtual void Tick(float DeltaTime) override;
 
     UPROPERTY(EditDefaultsOnly, Category = "Product Box")
     UStaticMeshComponent* BoxMesh;
@@ -21,6 +23,10 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Product Box")
     USceneComponent* ProductSpawnPoint;
 
+    // One instance per unit in the box, laid out from GridSize and ProductSpacing
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Product Box")
+    UInstancedStaticMeshComponent* ContentsInstances;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Product Box")
     TSubclassOf<AProduct> ProductClass;
 
@@ -36,17 +42,40 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Product Box")
     void FillBox(TSubclassOf<AProduct> ProductToFill);
 
+    // Makes the box hold Quantity units without laying out their instances. That only happens the first
+    // time someone takes from the box or picks it up, see MaterializeContents.
+    void SetDeferredContents(TSubclassOf<AProduct> ProductToFill, int32 Quantity);
+
+    // Lays out the deferred contents, if any
+    UFUNCTION(BlueprintCallable, Category = "Product Box")
+    void MaterializeContents();
+
+    UFUNCTION(BlueprintCallable, Category = "Product Box")
+    bool HasDeferredContents() const { return ProductCount > 0 && !bContentsBuilt; }
+
+    // Nothing has been taken out yet
+    UFUNCTION(BlueprintCallable, Category = "Product Box")
+    bool IsUnopened() const { return ProductCount > 0 && ProductCount == MaxProducts; }
+
     UFUNCTION(BlueprintCallable, Category = "Product Box")
     void SetProductClass(TSubclassOf<AProduct> NewProductClass);
 
     UFUNCTION(BlueprintCallable, Category = "Product Box")
     AProduct* RemoveProduct();
 
+    // Takes up to Count products out of the box in one go. Each comes from the product pool, unattached and
+    // placed where its instance was, so the caller can parent it directly.
+    int32 RemoveProducts(int32 Count, TArray<AProduct*>& OutProducts);
+
+    // Takes up to Count products out of the box without making actors for them, for callers that
+    // only need the count to go down. Returns how many were taken.
+    int32 DiscardProducts(int32 Count);
+
     UFUNCTION(BlueprintCallable, Category = "Product Box")
-    int32 GetProductCount() const { return Products.Num(); }
+    int32 GetProductCount() const { return ProductCount; }
 
     UFUNCTION(BlueprintCallable, Category = "Product Box")
-    bool IsEmpty() const { return Products.Num() == 0; }
+    bool IsEmpty() const { return GetProductCount() == 0; }
 
     UFUNCTION(BlueprintCallable, Category = "Product Box")
     void AttachToCamera(UCameraComponent* Camera);
@@ -60,6 +89,8 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Product Box")
     TSubclassOf<AProduct> GetProductClass() const { return ProductClass; }
 
+    // Spawns a box holding Quantity units. The contents are deferred, so this costs one actor; bulk
+    // deliveries should go through UProductDeliveryService, which also spreads the boxes over frames.
     UFUNCTION(BlueprintCallable, Category = "Product Box")
     static AProductBox* SpawnProductBox(UObject* WorldContextObject, TSubclassOf<AProductBox> ProductBoxClass, TSubclassOf<AProduct> ProductToSpawn, int32 Quantity, FVector SpawnLocation, FVector Spacing, FIntVector Grid);
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Product Box")
@@ -77,11 +108,12 @@ protected:
     virtual void BeginPlay() override;
 
 private:
-    UPROPERTY()
-    TArray<AProduct*> Products;
-
+    // Rebuilds the instances for ProductCount units
     void ArrangeProducts();
 
+    int32 ProductCount;
+    bool bContentsBuilt;
+
     bool bIsAttachedToCamera;
 
     UPROPERTY()
@@ -0,0 +1,92 @@
+// ProductCatalog.cpp
+#include "ProductCatalog.h"
+#include "Product.h"
+#include "Algo/BinarySearch.h"
+
+void UProductCatalogItem::SetPrice(float NewPrice)
+{
+    if (!FMath::IsNearlyEqual(Price, NewPrice))
+    {
+        Price = NewPrice;
+        OnChanged.Broadcast(this);
+    }
+}
+
+void UProductCatalogItem::SetStock(int32 NewStock)
+{
+    NewStock = FMath::Max(NewStock, 0);
+    if (Stock != NewStock)
+    {
+        Stock = NewStock;
+        OnChanged.Broadcast(this);
+    }
+}
+
+UProductCatalogItem* UProductCatalog::RegisterProductClass(TSubclassOf<AProduct> ProductClass)
+{
+    const AProduct* DefaultProduct = ProductClass ? ProductClass->GetDefaultObject<AProduct>() : nullptr;
+    if (!DefaultProduct)
+    {
+        return nullptr;
+    }
+
+    if (UProductCatalogItem* Existing = FindItem(DefaultProduct->GetSKU()))
+    {
+        return Existing;
+    }
+    return AddItem(DefaultProduct->GetSKU(), DefaultProduct->GetProductName(), DefaultProduct->GetPrice(), ProductClass);
+}
+
+void UProductCatalog::AdjustStock(const AProduct* Product, int32 Delta)
+{
+    if (!Product || Delta == 0)
+    {
+        return;
+    }
+
+    UProductCatalogItem* Item = FindItem(Product->GetSKU());
+    if (!Item)
+    {
+        Item = AddItem(Product->GetSKU(), Product->GetProductName(), Product->GetPrice(), Product->GetClass());
+    }
+    Item->SetStock(Item->Stock + Delta);
+}
+
+UProductCatalogItem* UProductCatalog::FindItem(FName SKU) const
+{
+    UProductCatalogItem* const* Item = ItemsBySKU.Find(SKU);
+    return Item ? *Item : nullptr;
+}
+
+void UProductCatalog::FindByPrefix(const FString& Prefix, TArray<UProductCatalogItem*>& OutItems) const
+{
+    OutItems.Reset();
+
+    const FString LowerPrefix = Prefix.ToLower();
+    const int32 First = Algo::LowerBoundBy(SearchIndex, LowerPrefix, [](const FSearchEntry& Entry) -> const FString& { return Entry.LowerName; });
+
+    for (int32 i = First; i < SearchIndex.Num() && SearchIndex[i].LowerName.StartsWith(LowerPrefix, ESearchCase::CaseSensitive); ++i)
+    {
+        OutItems.Add(Items[SearchIndex[i].ItemIndex]);
+    }
+}
+
+UProductCatalogItem* UProductCatalog::AddItem(FName SKU, const FString& DisplayName, float Price, TSubclassOf<AProduct> ProductClass)
+{
+    UProductCatalogItem* Item = NewObject<UProductCatalogItem>(this);
+    Item->SKU = SKU;
+    Item->DisplayName = DisplayName;
+    Item->Price = Price;
+    Item->ProductClass = ProductClass;
+
+    const int32 ItemIndex = Items.Add(Item);
+    ItemsBySKU.Add(SKU, Item);
+
+    // Insert at the sorted position instead of re-sorting the whole index
+    FSearchEntry Entry{ DisplayName.ToLower(), ItemIndex };
+    const int32 InsertAt = Algo::UpperBoundBy(SearchIndex, Entry.LowerName, [](const FSearchEntry& Existing) -> const FString& { return Existing.LowerName; });
+    SearchIndex.Insert(MoveTemp(Entry), InsertAt);
+
+    OnItemsAdded.Broadcast();
+    return Item;
+}
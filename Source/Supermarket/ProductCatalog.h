@@ -0,0 +1,102 @@
+// ProductCatalog.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "ProductCatalog.generated.h"
+
+class AProduct;
+class UProductCatalogItem;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnCatalogItemChanged, UProductCatalogItem* /*Item*/);
+
+// One SKU of the store as shown on the tablet. Also serves as the list item object of the tablet's
+// list view, so only the rows currently on screen hold an entry widget bound to OnChanged.
+UCLASS(BlueprintType)
+class SUPERMARKET_API UProductCatalogItem : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    FName GetSKU() const { return SKU; }
+
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    FString GetDisplayName() const { return DisplayName; }
+
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    float GetPrice() const { return Price; }
+
+    // Units currently on the shelves
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    int32 GetStock() const { return Stock; }
+
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    TSubclassOf<AProduct> GetProductClass() const { return ProductClass; }
+
+    void SetPrice(float NewPrice);
+    void SetStock(int32 NewStock);
+
+    // Fired only when the price or stock actually changes
+    FOnCatalogItemChanged OnChanged;
+
+private:
+    friend class UProductCatalog;
+
+    UPROPERTY()
+    FName SKU;
+
+    UPROPERTY()
+    FString DisplayName;
+
+    UPROPERTY()
+    TSubclassOf<AProduct> ProductClass;
+
+    float Price = 0.0f;
+    int32 Stock = 0;
+};
+
+// Every SKU the store carries, with a sorted name index for prefix search
+UCLASS(BlueprintType)
+class SUPERMARKET_API UProductCatalog : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // Adds the SKU of the given product class if it isn't in the catalog yet
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    UProductCatalogItem* RegisterProductClass(TSubclassOf<AProduct> ProductClass);
+
+    // Shelves report every unit they gain or lose here
+    void AdjustStock(const AProduct* Product, int32 Delta);
+
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    UProductCatalogItem* FindItem(FName SKU) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    TArray<UProductCatalogItem*> GetItems() const { return Items; }
+
+    // Items whose name starts with Prefix (case insensitive), in name order. An empty prefix returns everything.
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    void FindByPrefix(const FString& Prefix, TArray<UProductCatalogItem*>& OutItems) const;
+
+    // Fired when a SKU is added, list views showing the whole catalog need to pick it up
+    FSimpleMulticastDelegate OnItemsAdded;
+
+private:
+    UProductCatalogItem* AddItem(FName SKU, const FString& DisplayName, float Price, TSubclassOf<AProduct> ProductClass);
+
+    UPROPERTY()
+    TArray<UProductCatalogItem*> Items;
+
+    TMap<FName, UProductCatalogItem*> ItemsBySKU;
+
+    struct FSearchEntry
+    {
+        FString LowerName;
+        int32 ItemIndex;
+    };
+
+    // Sorted by LowerName, a prefix query is a binary search for the first match followed by a short scan
+    TArray<FSearchEntry> SearchIndex;
+};
@@ -0,0 +1,70 @@
+// ProductDeliveryService.cpp
+#include "ProductDeliveryService.h"
+#include "ProductBox.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "HAL/PlatformTime.h"
+
+UProductDeliveryService::UProductDeliveryService()
+{
+    MaxBoxesPerFrame = 2;
+    MaxMillisecondsPerFrame = 1.0f;
+
+    NextPending = 0;
+    NextDeliveryId = 1;
+    bSliceScheduled = false;
+}
+
+int32 UProductDeliveryService::RequestDelivery(const FProductBoxDelivery& Delivery)
+{
+    if (!Delivery.BoxClass || !Delivery.ProductClass || Delivery.Quantity <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ProductDelivery: Ignoring delivery without a box class, product class or quantity"));
+        return INDEX_NONE;
+    }
+
+    const int32 DeliveryId = NextDeliveryId++;
+    PendingDeliveries.Add({ DeliveryId, Delivery });
+    ScheduleSlice();
+    return DeliveryId;
+}
+
+void UProductDeliveryService::ScheduleSlice()
+{
+    UWorld* World = GetWorld();
+    if (!bSliceScheduled && World)
+    {
+        bSliceScheduled = true;
+        World->GetTimerManager().SetTimerForNextTick(this, &UProductDeliveryService::ProcessSlice);
+    }
+}
+
+void UProductDeliveryService::ProcessSlice()
+{
+    bSliceScheduled = false;
+
+    // At least one box per frame so a slow spawn can't stall the queue
+    const double SliceEnd = FPlatformTime::Seconds() + MaxMillisecondsPerFrame / 1000.0;
+    int32 Spawned = 0;
+    while (NextPending < PendingDeliveries.Num() && Spawned < MaxBoxesPerFrame && (Spawned == 0 || FPlatformTime::Seconds() < SliceEnd))
+    {
+        const FPendingDelivery Pending = PendingDeliveries[NextPending++];
+        const FProductBoxDelivery& Delivery = Pending.Delivery;
+
+        AProductBox* Box = AProductBox::SpawnProductBox(this, Delivery.BoxClass, Delivery.ProductClass, Delivery.Quantity,
+            Delivery.Location, Delivery.Spacing, Delivery.Grid);
+        Spawned++;
+
+        OnBoxDelivered.Broadcast(Pending.DeliveryId, Box);
+    }
+
+    if (NextPending < PendingDeliveries.Num())
+    {
+        ScheduleSlice();
+        return;
+    }
+
+    PendingDeliveries.Reset();
+    NextPending = 0;
+    OnDeliveriesComplete.Broadcast();
+}
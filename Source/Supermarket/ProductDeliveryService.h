@@ -0,0 +1,84 @@
+// ProductDeliveryService.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "ProductDeliveryService.generated.h"
+
+class AProduct;
+class AProductBox;
+
+// One box to deliver
+USTRUCT(BlueprintType)
+struct FProductBoxDelivery
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Delivery")
+    TSubclassOf<AProductBox> BoxClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Delivery")
+    TSubclassOf<AProduct> ProductClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Delivery")
+    int32 Quantity = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Delivery")
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Delivery")
+    FVector Spacing = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Delivery")
+    FIntVector Grid = FIntVector(1, 1, 1);
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnProductBoxDelivered, int32 /*DeliveryId*/, AProductBox* /*Box*/);
+
+// Turns box orders into actors a few at a time. Orders are queued as data and spawned at the start of
+// the following frames, at most MaxBoxesPerFrame and MaxMillisecondsPerFrame per frame. The boxes come
+// with deferred contents, so a delivery never spawns products until a box is opened or picked up.
+UCLASS()
+class SUPERMARKET_API UProductDeliveryService : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UProductDeliveryService();
+
+    // Queues a box and returns the id OnBoxDelivered will report it with
+    UFUNCTION(BlueprintCallable, Category = "Delivery")
+    int32 RequestDelivery(const FProductBoxDelivery& Delivery);
+
+    UFUNCTION(BlueprintCallable, Category = "Delivery")
+    int32 GetNumPendingDeliveries() const { return PendingDeliveries.Num() - NextPending; }
+
+    // Fired for every box once it is in the world; Box is null if it failed to spawn
+    FOnProductBoxDelivered OnBoxDelivered;
+
+    // Fired when the last queued box has been delivered
+    FSimpleMulticastDelegate OnDeliveriesComplete;
+
+    UPROPERTY(EditAnywhere, Category = "Delivery", meta = (ClampMin = "1"))
+    int32 MaxBoxesPerFrame;
+
+    UPROPERTY(EditAnywhere, Category = "Delivery", meta = (ClampMin = "0.1"))
+    float MaxMillisecondsPerFrame;
+
+private:
+    void ScheduleSlice();
+    void ProcessSlice();
+
+    struct FPendingDelivery
+    {
+        int32 DeliveryId;
+        FProductBoxDelivery Delivery;
+    };
+
+    // Consumed from NextPending on, compacted once the queue runs dry
+    TArray<FPendingDelivery> PendingDeliveries;
+    int32 NextPending;
+
+    int32 NextDeliveryId;
+    bool bSliceScheduled;
+};
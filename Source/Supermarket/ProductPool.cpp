@@ -0,0 +1,90 @@
+// ProductPool.cpp
+#include "ProductPool.h"
+#include "Engine/World.h"
+
+UProductPool::UProductPool()
+{
+    MaxPooledPerClass = 64;
+}
+
+AProduct* UProductPool::Acquire(TSubclassOf<AProduct> ProductClass, const FTransform& Transform)
+{
+    if (!ProductClass)
+    {
+        return nullptr;
+    }
+
+    AProduct* Product = nullptr;
+    if (FProductPoolBucket* Bucket = FreeProducts.Find(ProductClass))
+    {
+        while (!Product && Bucket->Products.Num() > 0)
+        {
+            Product = Bucket->Products.Pop(false);
+            if (!IsValid(Product))
+            {
+                Product = nullptr;
+            }
+        }
+    }
+
+    if (Product)
+    {
+        // Keep the product's own scale, only place it
+        Product->SetActorLocationAndRotation(Transform.GetLocation(), Transform.GetRotation());
+    }
+    else
+    {
+        UWorld* World = GetWorld();
+        if (!World)
+        {
+            return nullptr;
+        }
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        Product = World->SpawnActor<AProduct>(ProductClass, Transform.GetLocation(), Transform.Rotator(), SpawnParams);
+        if (!Product)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("ProductPool: Failed to spawn %s"), *ProductClass->GetName());
+            return nullptr;
+        }
+    }
+
+    Product->SetActorHiddenInGame(false);
+    Product->SetProductState(EProductState::Loose);
+    if (Product->ProductMesh)
+    {
+        Product->ProductMesh->SetVisibility(true);
+    }
+    return Product;
+}
+
+void UProductPool::Release(AProduct* Product)
+{
+    if (!IsValid(Product))
+    {
+        return;
+    }
+
+    Product->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+    Product->SetActorHiddenInGame(true);
+    Product->SetProductState(EProductState::Bagged);
+
+    FProductPoolBucket& Bucket = FreeProducts.FindOrAdd(Product->GetClass());
+    if (Bucket.Products.Num() >= MaxPooledPerClass)
+    {
+        Product->Destroy();
+        return;
+    }
+    Bucket.Products.Add(Product);
+}
+
+int32 UProductPool::GetNumPooled() const
+{
+    int32 NumPooled = 0;
+    for (const TPair<TSubclassOf<AProduct>, FProductPoolBucket>& Pair : FreeProducts)
+    {
+        NumPooled += Pair.Value.Products.Num();
+    }
+    return NumPooled;
+}
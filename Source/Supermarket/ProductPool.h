@@ -0,0 +1,44 @@
+// ProductPool.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Product.h"
+#include "ProductPool.generated.h"
+
+USTRUCT()
+struct FProductPoolBucket
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<AProduct*> Products;
+};
+
+// Hidden, collision free product actors kept around for reuse. Bags only hold SKU records, so products
+// exist as actors while they are on a shelf, in a hand or on a checkout counter. Everything that stops
+// showing a product hands it back here instead of destroying it.
+UCLASS()
+class SUPERMARKET_API UProductPool : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UProductPool();
+
+    // A visible, loose product of the given class at Transform, reused from the pool when possible
+    AProduct* Acquire(TSubclassOf<AProduct> ProductClass, const FTransform& Transform);
+
+    // Detaches and hides the product and keeps it for the next Acquire of its class
+    void Release(AProduct* Product);
+
+    int32 GetNumPooled() const;
+
+    // Products kept per class, anything released beyond that is destroyed
+    UPROPERTY(EditAnywhere, Category = "Pool")
+    int32 MaxPooledPerClass;
+
+private:
+    UPROPERTY()
+    TMap<TSubclassOf<AProduct>, FProductPoolBucket> FreeProducts;
+};
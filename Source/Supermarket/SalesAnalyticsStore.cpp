@@ -0,0 +1,186 @@
+// SalesAnalyticsStore.cpp
+#include "SalesAnalyticsStore.h"
+#include "SupermarketGameState.h"
+#include "Algo/BinarySearch.h"
+
+FSalesAnalyticsStore::FSalesAnalyticsStore(float InSecondsPerDay)
+    : SecondsPerDay(FMath::Max(InSecondsPerDay, 60.0f))
+{
+}
+
+void FSalesAnalyticsStore::Reset()
+{
+    Times.Reset();
+    SkuIndices.Reset();
+    Quantities.Reset();
+    Cents.Reset();
+    CheckoutIndices.Reset();
+    SkuNames.Reset();
+    SkuLookup.Reset();
+    CheckoutNames.Reset();
+    CheckoutLookup.Reset();
+    MinuteCents.Reset();
+    MinuteQuantities.Reset();
+    SkuQuantities.Reset();
+    DaySkuQuantities.Reset();
+}
+
+void FSalesAnalyticsStore::AddTransaction(const FSupermarketTransaction& Transaction)
+{
+    // Keep the time column sorted even if a caller hands in a slightly older timestamp
+    const float Time = Times.Num() > 0 ? FMath::Max(Transaction.Timestamp, Times.Last()) : FMath::Max(Transaction.Timestamp, 0.0f);
+    const int32 Minute = FMath::FloorToInt(Time / 60.0f);
+    const int32 Day = GetDay(Time);
+    const int32 CheckoutIndex = FindOrAddCheckout(Transaction.CheckoutId);
+
+    if (MinuteCents.Num() <= Minute)
+    {
+        MinuteCents.SetNumZeroed(Minute + 1);
+        MinuteQuantities.SetNumZeroed(Minute + 1);
+    }
+    if (DaySkuQuantities.Num() <= Day)
+    {
+        DaySkuQuantities.SetNum(Day + 1);
+    }
+
+    for (const FSkuCount& Line : Transaction.Items)
+    {
+        const int32 SkuIndex = FindOrAddSku(Line.SKU);
+
+        Times.Add(Time);
+        SkuIndices.Add(SkuIndex);
+        Quantities.Add(Line.Quantity);
+        Cents.Add(Line.Cents);
+        CheckoutIndices.Add(CheckoutIndex);
+
+        MinuteCents[Minute] += Line.Cents;
+        MinuteQuantities[Minute] += Line.Quantity;
+        SkuQuantities[SkuIndex] += Line.Quantity;
+
+        TArray<int32>& DayQuantities = DaySkuQuantities[Day];
+        if (DayQuantities.Num() <= SkuIndex)
+        {
+            DayQuantities.SetNumZeroed(SkuNames.Num());
+        }
+        DayQuantities[SkuIndex] += Line.Quantity;
+    }
+}
+
+int32 FSalesAnalyticsStore::FindOrAddSku(FName SKU)
+{
+    if (const int32* Existing = SkuLookup.Find(SKU))
+    {
+        return *Existing;
+    }
+
+    const int32 SkuIndex = SkuNames.Add(SKU);
+    SkuLookup.Add(SKU, SkuIndex);
+    SkuQuantities.Add(0);
+    return SkuIndex;
+}
+
+int32 FSalesAnalyticsStore::FindOrAddCheckout(FName CheckoutId)
+{
+    if (const int32* Existing = CheckoutLookup.Find(CheckoutId))
+    {
+        return *Existing;
+    }
+
+    const int32 CheckoutIndex = CheckoutNames.Add(CheckoutId);
+    CheckoutLookup.Add(CheckoutId, CheckoutIndex);
+    return CheckoutIndex;
+}
+
+int32 FSalesAnalyticsStore::LowerBound(float Time) const
+{
+    return Algo::LowerBound(Times, Time);
+}
+
+template <typename ColumnType>
+int64 FSalesAnalyticsStore::SumColumn(const TArray<ColumnType>& Column, int32 Begin, int32 End) const
+{
+    // Plain loop over contiguous memory, the compiler vectorizes it
+    const ColumnType* Data = Column.GetData();
+    int64 Sum = 0;
+    for (int32 i = Begin; i < End; ++i)
+    {
+        Sum += Data[i];
+    }
+    return Sum;
+}
+
+template <typename ValueType>
+int64 FSalesAnalyticsStore::SumRange(const TArray<ValueType>& MinuteRollup, const TArray<ValueType>& Column, float StartTime, float EndTime) const
+{
+    if (EndTime <= StartTime || Times.Num() == 0)
+    {
+        return 0;
+    }
+
+    const int32 FirstFullMinute = FMath::CeilToInt(StartTime / 60.0f);
+    const int32 EndFullMinute = FMath::Min(FMath::FloorToInt(EndTime / 60.0f), MinuteRollup.Num());
+
+    if (FirstFullMinute >= EndFullMinute)
+    {
+        // Less than a whole minute, sum the raw lines
+        return SumColumn(Column, LowerBound(StartTime), LowerBound(EndTime));
+    }
+
+    int64 Sum = SumColumn(MinuteRollup, FMath::Max(FirstFullMinute, 0), EndFullMinute);
+    Sum += SumColumn(Column, LowerBound(StartTime), LowerBound(FirstFullMinute * 60.0f));
+    Sum += SumColumn(Column, LowerBound(EndFullMinute * 60.0f), LowerBound(EndTime));
+    return Sum;
+}
+
+int64 FSalesAnalyticsStore::GetRevenueCents(float StartTime, float EndTime) const
+{
+    return SumRange(MinuteCents, Cents, StartTime, EndTime);
+}
+
+int64 FSalesAnalyticsStore::GetItemsSold(float StartTime, float EndTime) const
+{
+    return SumRange(MinuteQuantities, Quantities, StartTime, EndTime);
+}
+
+void FSalesAnalyticsStore::GetRevenuePerHour(float StartTime, int32 NumHours, TArray<int64>& OutCents) const
+{
+    OutCents.SetNumUninitialized(FMath::Max(NumHours, 0));
+    for (int32 Hour = 0; Hour < OutCents.Num(); ++Hour)
+    {
+        const float HourStart = StartTime + Hour * 3600.0f;
+        OutCents[Hour] = GetRevenueCents(HourStart, HourStart + 3600.0f);
+    }
+}
+
+void FSalesAnalyticsStore::GetTopSellers(int32 Day, int32 Count, TArray<TPair<FName, int32>>& OutSellers) const
+{
+    OutSellers.Reset();
+    if (!DaySkuQuantities.IsValidIndex(Day))
+    {
+        return;
+    }
+
+    const TArray<int32>& DayQuantities = DaySkuQuantities[Day];
+    for (int32 SkuIndex = 0; SkuIndex < DayQuantities.Num(); ++SkuIndex)
+    {
+        if (DayQuantities[SkuIndex] > 0)
+        {
+            OutSellers.Emplace(SkuNames[SkuIndex], DayQuantities[SkuIndex]);
+        }
+    }
+
+    OutSellers.Sort([](const TPair<FName, int32>& A, const TPair<FName, int32>& B) { return A.Value > B.Value; });
+    OutSellers.SetNum(FMath::Min(OutSellers.Num(), FMath::Max(Count, 0)));
+}
+
+void FSalesAnalyticsStore::GetTopSellersAllTime(int32 Count, TArray<TPair<FName, int64>>& OutSellers) const
+{
+    OutSellers.Reset(SkuNames.Num());
+    for (int32 SkuIndex = 0; SkuIndex < SkuNames.Num(); ++SkuIndex)
+    {
+        OutSellers.Emplace(SkuNames[SkuIndex], SkuQuantities[SkuIndex]);
+    }
+
+    OutSellers.Sort([](const TPair<FName, int64>& A, const TPair<FName, int64>& B) { return A.Value > B.Value; });
+    OutSellers.SetNum(FMath::Min(OutSellers.Num(), FMath::Max(Count, 0)));
+}
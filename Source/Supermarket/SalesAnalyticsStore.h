@@ -0,0 +1,77 @@
+// SalesAnalyticsStore.h
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FSupermarketTransaction;
+
+// In-memory sales history for reports. Every sold SKU line is appended to a set of parallel columns
+// (time, SKU, quantity, cents, checkout) and folded into per-minute and per-day-per-SKU rollups as it
+// comes in, so queries sum a few small contiguous arrays instead of walking transactions.
+// Times are world seconds and only ever increase, which keeps every column sorted by time.
+class SUPERMARKET_API FSalesAnalyticsStore
+{
+public:
+    explicit FSalesAnalyticsStore(float InSecondsPerDay = 86400.0f);
+
+    void AddTransaction(const FSupermarketTransaction& Transaction);
+    void Reset();
+
+    int32 GetNumLines() const { return Times.Num(); }
+
+    // Revenue of all sales with StartTime <= time < EndTime
+    int64 GetRevenueCents(float StartTime, float EndTime) const;
+
+    // Units sold in the given range
+    int64 GetItemsSold(float StartTime, float EndTime) const;
+
+    // Revenue of each hour from StartTime on, one entry per hour
+    void GetRevenuePerHour(float StartTime, int32 NumHours, TArray<int64>& OutCents) const;
+
+    // SKUs with the most units sold on the given day, best first
+    void GetTopSellers(int32 Day, int32 Count, TArray<TPair<FName, int32>>& OutSellers) const;
+
+    // SKUs with the most units sold over the whole history, best first
+    void GetTopSellersAllTime(int32 Count, TArray<TPair<FName, int64>>& OutSellers) const;
+
+    int32 GetDay(float Time) const { return FMath::Max(0, FMath::FloorToInt(Time / SecondsPerDay)); }
+
+    const TArray<FName>& GetSkus() const { return SkuNames; }
+
+private:
+    int32 FindOrAddSku(FName SKU);
+    int32 FindOrAddCheckout(FName CheckoutId);
+
+    // First line at or after Time
+    int32 LowerBound(float Time) const;
+
+    template <typename ColumnType>
+    int64 SumColumn(const TArray<ColumnType>& Column, int32 Begin, int32 End) const;
+
+    // Whole minutes come from the rollup, only the partial minutes at either end touch the raw column
+    template <typename ValueType>
+    int64 SumRange(const TArray<ValueType>& MinuteRollup, const TArray<ValueType>& Column, float StartTime, float EndTime) const;
+
+    float SecondsPerDay;
+
+    // One entry per sold SKU line
+    TArray<float> Times;
+    TArray<int32> SkuIndices;
+    TArray<int32> Quantities;
+    TArray<int64> Cents;
+    TArray<int32> CheckoutIndices;
+
+    // Dictionaries the index columns point into
+    TArray<FName> SkuNames;
+    TMap<FName, int32> SkuLookup;
+    TArray<FName> CheckoutNames;
+    TMap<FName, int32> CheckoutLookup;
+
+    // Indexed by minute since world start
+    TArray<int64> MinuteCents;
+    TArray<int32> MinuteQuantities;
+
+    // Units per SKU, for all time and for each day ([Day][SkuIndex])
+    TArray<int64> SkuQuantities;
+    TArray<TArray<int32>> DaySkuQuantities;
+};
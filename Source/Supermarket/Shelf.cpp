@@ -1,10 +1,17 @@
 // Shelf.cpp
 #include "Shelf.h"
+#include "Supermarket.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "NavigationSystem.h"
 #include "AIController.h"
+#include "SupermarketGameState.h"
+#include "ProductCatalog.h"
+#include "ProductPool.h"
+#include "StartupStockingService.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Net/UnrealNetwork.h"
 
 AShelf::AShelf()
 {
@@ -17,6 +24,7 @@ AShelf::AShelf()
 
     ShelfMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ShelfMesh"));
     ShelfMesh->SetupAttachment(RootComponent);
+    ShelfMesh->SetCollisionResponseToChannel(ECC_Interactable, ECR_Block);
 
     MaxProducts = 25; // 1x3x5 grid
     ProductSpacing = FVector(20.0f, 20.0f, 2.67071f); // Adjust as needed
@@ -33,6 +41,15 @@ AShelf::AShelf()
 
     bStartFullyStocked = false; // Set default value
     CurrentProductClass = nullptr;
+
+    bBulkStocking = true;
+    bAnimateBulkStocking = true;
+    StockingRevealInterval = 0.3f;
+
+    // Shelves only send their stock, and only after it changed
+    bReplicates = true;
+    NetDormancy = DORM_Initial;
+    StockSlots.Owner = this;
 }
 
 
@@ -83,7 +100,24 @@ void AShelf::BeginPlay()
 
     FVector Extent = ShelfMesh->Bounds.BoxExtent;
     SetupAccessPoint();
-    InitializeShelf();
+
+    // Clients draw the replicated slots instead, see RebuildStockVisuals
+    if (HasAuthority())
+    {
+        InitializeShelf();
+    }
+}
+
+void AShelf::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // A client shelf that goes away no longer shows its units
+    const ASupermarketGameState* GameState = GetWorld() ? GetWorld()->GetGameState<ASupermarketGameState>() : nullptr;
+    if (!HasAuthority() && GameState && GameState->GetProductCatalog())
+    {
+        UpdateClientCatalogStock(GameState->GetProductCatalog(), TMap<FName, int32>());
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 void AShelf::UpdateProductSpawnPointRotation()
@@ -135,22 +169,18 @@ void AShelf::InitializeShelf()
 {
     if (bStartFullyStocked && ProductClass)
     {
-        // Stock the shelf to its maximum capacity
-        while (Products.Num() < MaxProducts)
+        // The fill is spread over the next frames together with every other shelf in the store
+        ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+        if (GameState && GameState->GetStartupStocking())
         {
-            int32 currentProductCount = Products.Num();
-            int32 row = currentProductCount / 5;  // Assuming 5 products per row
-            int32 column = currentProductCount % 5;
-
-            FVector RelativeLocation = FVector(
-                column * ProductSpacing.X,
-                row * ProductSpacing.Y,
-                ProductSpacing.Z  // Height above the shelf
-            );
-
-            AddProduct(RelativeLocation);
+            GameState->GetStartupStocking()->RegisterShelf(this);
+            UE_LOG(LogTemp, Display, TEXT("Shelf %s: Queued for initial stocking"), *GetName());
+        }
+        else
+        {
+            FillInitialStock(GetRemainingCapacity());
+            UE_LOG(LogTemp, Display, TEXT("Shelf %s: Initialized as fully stocked with %d products"), *GetName(), Products.Num());
         }
-        UE_LOG(LogTemp, Display, TEXT("Shelf %s: Initialized as fully stocked with %d products"), *GetName(), Products.Num());
     }
     else
     {
@@ -196,10 +226,11 @@ bool AShelf::AddProduct(const FVector& RelativeLocation)
 
         Products.Add(NewProduct);
         NewProduct->AttachToComponent(ProductSpawnPoint, FAttachmentTransformRules::KeepWorldTransform);
+        ReportStockChange(NewProduct, 1);
 
-        // Make the product visible and enable collision
+        // Make the product visible, shelved products only answer Product channel queries
         NewProduct->SetActorHiddenInGame(false);
-        NewProduct->SetActorEnableCollision(true);
+        NewProduct->SetProductState(EProductState::Shelved);
 
         UE_LOG(LogTemp, Display, TEXT("Added product to shelf. Total products: %d"), Products.Num());
 
@@ -212,36 +243,164 @@ bool AShelf::AddProduct(const FVector& RelativeLocation)
 
 void AShelf::StartStockingShelf(TSubclassOf<AProduct> ProductToStock)
 {
-    if (!bIsStocking && ProductToStock)
+    // Clients stock through ASupermarketCharacter::ServerStockShelf, the stock itself is server state
+    if (!HasAuthority() || bIsStocking || !ProductToStock)
+    {
+        return;
+    }
+
+    if (ProductClass && Products.Num() > 0 && ProductClass != ProductToStock)
+    {
+        // If trying to stock a different product type on a non-empty shelf, prevent it
+        UE_LOG(LogTemp, Warning, TEXT("Cannot stock different product type. Shelf is dedicated to %s"), *ProductClass->GetName());
+        return;
+    }
+
+    // An empty shelf or one without a product class takes the new product, otherwise it matches already
+    const bool bNewProductType = ProductClass != ProductToStock;
+    ProductClass = ProductToStock;
+    bIsStocking = true;
+    if (bBulkStocking)
+    {
+        StockFromBox(ProductBox, GetRemainingCapacity());
+        bIsStocking = false;
+    }
+    else
+    {
+        ContinueStocking();
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("%s stocking shelf with product type: %s"),
+        bNewProductType ? TEXT("Started") : TEXT("Continuing"), *ProductClass->GetName());
+}
+
+
+void AShelf::StopStockingShelf()
+{
+    bIsStocking = false;
+    GetWorld()->GetTimerManager().ClearTimer(ContinuousStockingTimerHandle);
+}
+
+FVector AShelf::GetSlotRelativeLocation(int32 SlotIndex) const
+{
+    int32 row = SlotIndex / 5;  // Assuming 5 products per row
+    int32 column = SlotIndex % 5;
+
+    return FVector(
+        column * ProductSpacing.X,
+        row * ProductSpacing.Y,
+        ProductSpacing.Z  // Height above the shelf
+    );
+}
+
+int32 AShelf::StockFromBox(AProductBox* SourceBox, int32 Count)
+{
+    if (!HasAuthority() || !SourceBox || !ProductSpawnPoint || Count <= 0)
+    {
+        return 0;
+    }
+
+    TSubclassOf<AProduct> BoxProductClass = SourceBox->GetProductClass();
+    if (!ProductClass || Products.Num() == 0)
+    {
+        ProductClass = BoxProductClass;
+    }
+    else if (BoxProductClass != ProductClass)
     {
-        if (!ProductClass || Products.Num() == 0)
+        UE_LOG(LogTemp, Warning, TEXT("Product in box does not match shelf's product type"));
+        return 0;
+    }
+
+    TArray<AProduct*> IncomingProducts;
+    SourceBox->RemoveProducts(FMath::Min(Count, GetRemainingCapacity()), IncomingProducts);
+    if (IncomingProducts.Num() == 0)
+    {
+        return 0;
+    }
+
+    // Every unit is the same class, so the bottom offset only has to be measured once.
+    // It is expressed in the spawn point's space so each product can be placed with a single relative transform.
+    FVector BottomOffset = FVector::ZeroVector;
+    if (UStaticMeshComponent* ReferenceMesh = IncomingProducts[0] ? IncomingProducts[0]->ProductMesh : nullptr)
+    {
+        BottomOffset = ProductSpawnPoint->GetComponentRotation().UnrotateVector(FVector(0, 0, ReferenceMesh->Bounds.BoxExtent.Z));
+    }
+
+    // Location and rotation are taken from the relative values set below, scale is kept as is
+    const FAttachmentTransformRules AttachRules(EAttachmentRule::KeepRelative, EAttachmentRule::KeepRelative, EAttachmentRule::KeepWorld, false);
+
+    // Nobody watches the reveal when the store is fast-forwarded
+    const bool bAnimateReveal = bAnimateBulkStocking && !ASupermarketGameState::ShouldSkipCosmeticsIn(GetWorld());
+
+    Products.Reserve(Products.Num() + IncomingProducts.Num());
+    for (AProduct* Product : IncomingProducts)
+    {
+        USceneComponent* ProductRoot = Product ? Product->GetRootComponent() : nullptr;
+        if (!ProductRoot)
         {
-            // If the shelf is empty or has no product class set, allow stocking with the new product
-            ProductClass = ProductToStock;
-            bIsStocking = true;
-            ContinueStocking();
-            UE_LOG(LogTemp, Display, TEXT("Started stocking shelf with new product type: %s"), *ProductClass->GetName());
+            continue;
         }
-        else if (ProductClass == ProductToStock)
+
+        // Products come out of the box unattached, write the shelf slot directly
+        // so attaching is the only world transform update for this unit
+        ProductRoot->SetRelativeLocation_Direct(GetSlotRelativeLocation(Products.Num()) + BottomOffset);
+        ProductRoot->SetRelativeRotation_Direct(FRotator::ZeroRotator);
+        ProductRoot->AttachToComponent(ProductSpawnPoint, AttachRules);
+
+        if (bAnimateReveal)
         {
-            // If the product type matches the current shelf product, allow stocking
-            bIsStocking = true;
-            ContinueStocking();
-            UE_LOG(LogTemp, Display, TEXT("Continuing to stock shelf with existing product type: %s"), *ProductClass->GetName());
+            if (!Product->IsHidden())
+            {
+                Product->SetActorHiddenInGame(true);
+            }
+            ProductsPendingReveal.Add(Product);
         }
-        else
+        else if (Product->IsHidden())
         {
-            // If trying to stock a different product type on a non-empty shelf, prevent it
-            UE_LOG(LogTemp, Warning, TEXT("Cannot stock different product type. Shelf is dedicated to %s"), *ProductClass->GetName());
+            Product->SetActorHiddenInGame(false);
         }
+
+        Product->SetProductState(EProductState::Shelved);
+
+        Products.Add(Product);
     }
-}
 
+    if (ProductsPendingReveal.Num() > 0 && !GetWorldTimerManager().IsTimerActive(RevealTimerHandle))
+    {
+        GetWorldTimerManager().SetTimer(RevealTimerHandle, this, &AShelf::RevealNextStockedProduct, StockingRevealInterval, true);
+    }
 
-void AShelf::StopStockingShelf()
+    ReportStockChange(IncomingProducts[0], IncomingProducts.Num());
+
+    UE_LOG(LogTemp, Display, TEXT("Shelf %s: Bulk stocked %d products. Total products: %d"), *GetName(), IncomingProducts.Num(), Products.Num());
+
+    return IncomingProducts.Num();
+}
+
+void AShelf::RevealNextStockedProduct()
 {
-    bIsStocking = false;
-    GetWorld()->GetTimerManager().ClearTimer(ContinuousStockingTimerHandle);
+    // The speed may have gone up since stocking started, then the rest shows at once
+    const bool bRevealAll = ASupermarketGameState::ShouldSkipCosmeticsIn(GetWorld());
+
+    // Reveal in the order the products were placed
+    while (ProductsPendingReveal.Num() > 0)
+    {
+        AProduct* Product = ProductsPendingReveal[0];
+        ProductsPendingReveal.RemoveAt(0);
+        if (Product)
+        {
+            Product->SetActorHiddenInGame(false);
+            if (!bRevealAll)
+            {
+                break;
+            }
+        }
+    }
+
+    if (ProductsPendingReveal.Num() == 0)
+    {
+        GetWorldTimerManager().ClearTimer(RevealTimerHandle);
+    }
 }
 
 void AShelf::StockNextProduct()
@@ -254,16 +413,7 @@ void AShelf::StockNextProduct()
     int32 currentProductCount = Products.Num();
     if (currentProductCount < MaxProducts)
     {
-        int32 row = currentProductCount / 5;
-        int32 column = currentProductCount % 5;
-
-        FVector RelativeLocation = FVector(
-            column * ProductSpacing.X,
-            row * ProductSpacing.Y,
-            ProductSpacing.Z
-        );
-
-        if (AddProduct(RelativeLocation))
+        if (AddProduct(GetSlotRelativeLocation(currentProductCount)))
         {
             GetWorld()->GetTimerManager().SetTimer(StockingTimerHandle, this, &AShelf::StockNextProduct, 0.3f, false);
         }
@@ -291,7 +441,7 @@ bool AShelf::IsSpotEmpty(const FVector& RelativeLocation) const
     bool bIsEmpty = !GetWorld()->OverlapBlockingTestByChannel(
         WorldLocation,
         FQuat::Identity,
-        ECC_WorldStatic,
+        ECC_Product,
         CollisionShape,
         QueryParams
     );
@@ -307,7 +457,10 @@ AProduct* AShelf::RemoveNextProduct()
     {
         AProduct* RemovedProduct = Products.Last();
         Products.RemoveAt(Products.Num() - 1);
+        ProductsPendingReveal.RemoveSingle(RemovedProduct);
         RemovedProduct->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+        RemovedProduct->SetProductState(EProductState::Loose);
+        ReportStockChange(RemovedProduct, -1);
         return RemovedProduct;
     }
     return nullptr;
@@ -317,12 +470,12 @@ AProduct* AShelf::RemoveNextProduct()
 int32 AShelf::GetProductCount() const
 {
     //UE_LOG(LogTemp, Display, TEXT("Shelf %s: Current product count: %d"), *GetName(), Products.Num());
-    return Products.Num();
+    return HasAuthority() ? Products.Num() : StockSlots.Items.Num();
 }
 
 bool AShelf::IsFullyStocked() const
 {
-    return Products.Num() >= MaxProducts;
+    return GetProductCount() >= MaxProducts;
 }
 
 int32 AShelf::GetRemainingCapacity() const
@@ -342,16 +495,7 @@ void AShelf::ContinueStocking()
     int32 currentProductCount = Products.Num();
     if (currentProductCount < MaxProducts)
     {
-        int32 row = currentProductCount / 5;
-        int32 column = currentProductCount % 5;
-
-        FVector RelativeLocation = FVector(
-            column * ProductSpacing.X,
-            row * ProductSpacing.Y,
-            ProductSpacing.Z
-        );
-
-        if (AddProduct(RelativeLocation))
+        if (AddProduct(GetSlotRelativeLocation(currentProductCount)))
         {
             // If product was added successfully, continue stocking after a short delay
             GetWorld()->GetTimerManager().SetTimer(ContinuousStockingTimerHandle, this, &AShelf::ContinueStocking, 0.3f, false);
@@ -378,5 +522,248 @@ bool AShelf::GetNextProductLocation(FVector& OutLocation) const
         OutLocation = Products.Last()->GetActorLocation();
         return true;
     }
+
+    // Clients only have the slots, the last occupied one is where the next pick comes from
+    int32 LastSlotIndex = INDEX_NONE;
+    for (const FShelfSlotItem& Slot : StockSlots.Items)
+    {
+        LastSlotIndex = FMath::Max(LastSlotIndex, static_cast<int32>(Slot.SlotIndex));
+    }
+    if (!HasAuthority() && LastSlotIndex != INDEX_NONE && ProductSpawnPoint)
+    {
+        OutLocation = ProductSpawnPoint->GetComponentTransform().TransformPosition(GetSlotRelativeLocation(LastSlotIndex));
+        return true;
+    }
     return false;
-}
\ No newline at end of file
+}
+
+int32 AShelf::FillInitialStock(int32 MaxCount)
+{
+    ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+    UProductPool* Pool = GameState ? GameState->GetProductPool() : nullptr;
+    const int32 NumToAdd = FMath::Min(MaxCount, GetRemainingCapacity());
+    if (!ProductClass || !Pool || NumToAdd <= 0)
+    {
+        return 0;
+    }
+
+    // Same placement as StockFromBox: write the slot's relative transform, then attach once
+    const FAttachmentTransformRules AttachRules(EAttachmentRule::KeepRelative, EAttachmentRule::KeepRelative, EAttachmentRule::KeepWorld, false);
+    FVector BottomOffset = FVector::ZeroVector;
+
+    int32 Added = 0;
+    for (; Added < NumToAdd; ++Added)
+    {
+        AProduct* Product = Pool->Acquire(ProductClass, ProductSpawnPoint->GetComponentTransform());
+        USceneComponent* ProductRoot = Product ? Product->GetRootComponent() : nullptr;
+        if (!ProductRoot)
+        {
+            break;
+        }
+
+        if (Added == 0 && Product->ProductMesh)
+        {
+            BottomOffset = ProductSpawnPoint->GetComponentRotation().UnrotateVector(FVector(0, 0, Product->ProductMesh->Bounds.BoxExtent.Z));
+        }
+
+        ProductRoot->SetRelativeLocation_Direct(GetSlotRelativeLocation(Products.Num()) + BottomOffset);
+        ProductRoot->SetRelativeRotation_Direct(FRotator::ZeroRotator);
+        ProductRoot->AttachToComponent(ProductSpawnPoint, AttachRules);
+        Product->SetProductState(EProductState::Shelved);
+
+        Products.Add(Product);
+    }
+
+    if (Added > 0)
+    {
+        ReportStockChange(Products.Last(), Added);
+    }
+    return Added;
+}
+
+int32 AShelf::StockFromPool(TSubclassOf<AProduct> InProductClass, int32 Count)
+{
+    if (!HasAuthority() || !InProductClass || Count <= 0)
+    {
+        return 0;
+    }
+
+    if (ProductClass != InProductClass)
+    {
+        StopStockingShelf();
+        while (RemoveNextProduct())
+        {
+            // Remove all products from the shelf
+        }
+        ProductClass = InProductClass;
+    }
+    return FillInitialStock(Count);
+}
+
+void AShelf::ReportStockChange(const AProduct* Product, int32 Delta)
+{
+    // Clients get the stock through StockSlots, only the server writes it and the catalog
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    if (StockSlots.SyncWithProducts(Products))
+    {
+        FlushNetDormancy();
+    }
+
+    ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+    if (GameState && GameState->GetProductCatalog())
+    {
+        GameState->GetProductCatalog()->AdjustStock(Product, Delta);
+    }
+}
+
+void AShelf::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME(AShelf, StockSlots);
+}
+
+void AShelf::RebuildStockVisuals()
+{
+    if (HasAuthority() || !ProductSpawnPoint)
+    {
+        return;
+    }
+
+    // Replicated slots can arrive before the game state, try again once the catalog is there
+    ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>();
+    UProductCatalog* Catalog = GameState ? GameState->GetProductCatalog() : nullptr;
+    if (!Catalog)
+    {
+        GetWorldTimerManager().SetTimerForNextTick(this, &AShelf::RebuildStockVisuals);
+        return;
+    }
+
+    for (const TPair<FName, UInstancedStaticMeshComponent*>& Pair : StockInstances)
+    {
+        if (Pair.Value)
+        {
+            Pair.Value->ClearInstances();
+        }
+    }
+
+    // A handful of slots per shelf, rebuilding all of them is cheaper than tracking instance indices
+    TMap<FName, TArray<FTransform>> TransformsBySKU;
+    TMap<FName, int32> StockBySKU;
+    for (const FShelfSlotItem& Slot : StockSlots.Items)
+    {
+        // Products outside the game state's list are only known from here, the catalog learns about them first
+        const AProduct* DefaultProduct = Slot.ProductClass ? Slot.ProductClass->GetDefaultObject<AProduct>() : nullptr;
+        if (!DefaultProduct || !Catalog->RegisterProductClass(Slot.ProductClass))
+        {
+            continue;
+        }
+
+        const FName SKU = DefaultProduct->GetSKU();
+        StockBySKU.FindOrAdd(SKU)++;
+
+        UStaticMesh* ProductMesh = DefaultProduct->ProductMesh ? DefaultProduct->ProductMesh->GetStaticMesh() : nullptr;
+        if (!ProductMesh)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Shelf %s: No mesh for SKU %s"), *GetName(), *SKU.ToString());
+            continue;
+        }
+
+        UInstancedStaticMeshComponent*& Instances = StockInstances.FindOrAdd(SKU);
+        if (!Instances)
+        {
+            Instances = NewObject<UInstancedStaticMeshComponent>(this);
+            Instances->SetupAttachment(ProductSpawnPoint);
+            Instances->SetUsingAbsoluteScale(true);
+            Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            Instances->SetGenerateOverlapEvents(false);
+            Instances->SetCanEverAffectNavigation(false);
+            Instances->SetStaticMesh(ProductMesh);
+            Instances->RegisterComponent();
+        }
+
+        // Same placement as StockFromBox, the bottom of the product rests on the slot
+        const FVector ProductScale = DefaultProduct->GetProductData().Scale;
+        const FVector BottomOffset = FVector(0, 0, ProductMesh->GetBounds().BoxExtent.Z * FMath::Abs(ProductScale.Z));
+        TransformsBySKU.FindOrAdd(SKU).Emplace(FQuat::Identity, GetSlotRelativeLocation(Slot.SlotIndex) + BottomOffset, ProductScale);
+    }
+
+    for (TPair<FName, TArray<FTransform>>& Pair : TransformsBySKU)
+    {
+        StockInstances[Pair.Key]->AddInstances(Pair.Value, false);
+    }
+
+    UpdateClientCatalogStock(Catalog, StockBySKU);
+}
+
+void AShelf::UpdateClientCatalogStock(UProductCatalog* Catalog, const TMap<FName, int32>& NewStock)
+{
+    // The server counts stock as shelves change, clients only have the slots and sum what every shelf shows
+    for (const TPair<FName, int32>& Pair : ClientCatalogStock)
+    {
+        if (!NewStock.Contains(Pair.Key))
+        {
+            if (UProductCatalogItem* Item = Catalog->FindItem(Pair.Key))
+            {
+                Item->SetStock(Item->GetStock() - Pair.Value);
+            }
+        }
+    }
+
+    for (const TPair<FName, int32>& Pair : NewStock)
+    {
+        const int32 Delta = Pair.Value - ClientCatalogStock.FindRef(Pair.Key);
+        UProductCatalogItem* Item = Delta != 0 ? Catalog->FindItem(Pair.Key) : nullptr;
+        if (Item)
+        {
+            Item->SetStock(Item->GetStock() + Delta);
+        }
+    }
+
+    ClientCatalogStock = NewStock;
+}
+
+bool FShelfSlotArray::SyncWithProducts(const TArray<AProduct*>& Products)
+{
+    // Products fill the slots from the front and leave from the back, so Items[i] is slot i
+    bool bChanged = false;
+    if (Items.Num() > Products.Num())
+    {
+        Items.SetNum(Products.Num());
+        MarkArrayDirty();
+        bChanged = true;
+    }
+
+    for (int32 SlotIndex = 0; SlotIndex < Products.Num(); ++SlotIndex)
+    {
+        const TSubclassOf<AProduct> ProductClass = Products[SlotIndex] ? Products[SlotIndex]->GetClass() : nullptr;
+        if (SlotIndex == Items.Num())
+        {
+            FShelfSlotItem& Item = Items.AddDefaulted_GetRef();
+            Item.SlotIndex = static_cast<uint16>(SlotIndex);
+            Item.ProductClass = ProductClass;
+            MarkItemDirty(Item);
+            bChanged = true;
+        }
+        else if (Items[SlotIndex].ProductClass != ProductClass)
+        {
+            Items[SlotIndex].ProductClass = ProductClass;
+            MarkItemDirty(Items[SlotIndex]);
+            bChanged = true;
+        }
+    }
+    return bChanged;
+}
+
+void FShelfSlotArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+    // Once per received update, however many slots it touched
+    if (Owner)
+    {
+        Owner->RebuildStockVisuals();
+    }
+}
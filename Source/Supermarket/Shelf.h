@@ -6,11 +6,62 @@
 #include "Components/BoxComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SceneComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "Product.h"
 #include "ProductBox.h"
 #include "Shelf.generated.h"
 
+class AShelf;
+class UInstancedStaticMeshComponent;
+class UProductCatalog;
 
+// One occupied shelf slot as clients see it
+USTRUCT()
+struct FShelfSlotItem : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    uint16 SlotIndex = 0;
+
+    // Sent as a class reference so clients can draw and catalog products they have never seen
+    UPROPERTY()
+    TSubclassOf<AProduct> ProductClass;
+};
+
+// Occupied slots of a shelf. Only slots that were added, changed or emptied since the last update are sent,
+// clients draw the products from each slot's product class.
+USTRUCT()
+struct FShelfSlotArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FShelfSlotItem> Items;
+
+    // Not replicated, set by the owning shelf
+    UPROPERTY(NotReplicated)
+    AShelf* Owner = nullptr;
+
+    // Brings the slots in line with the shelf's products, slot i holds Products[i]. Returns true if anything changed.
+    bool SyncWithProducts(const TArray<AProduct*>& Products);
+
+    void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FShelfSlotItem, FShelfSlotArray>(Items, DeltaParms, *this);
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FShelfSlotArray> : public TStructOpsTypeTraitsBase2<FShelfSlotArray>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
 
 UCLASS()
 class SUPERMARKET_API AShelf : public AActor
@@ -66,6 +117,30 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Shelf")
     void StopStockingShelf();
 
+    // Moves up to Count products from SourceBox onto the shelf in a single call and returns how many were moved.
+    // Used by the player's bulk stocking and by automated restockers.
+    UFUNCTION(BlueprintCallable, Category = "Shelf")
+    int32 StockFromBox(AProductBox* SourceBox, int32 Count);
+
+    // When true, StartStockingShelf fills the shelf with StockFromBox instead of one unit per timer tick
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shelf")
+    bool bBulkStocking;
+
+    // Cosmetic only: bulk-stocked products are revealed one at a time at StockingRevealInterval
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shelf")
+    bool bAnimateBulkStocking;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Shelf", meta = (ClampMin = "0.01", EditCondition = "bAnimateBulkStocking"))
+    float StockingRevealInterval;
+
+    // Places up to MaxCount new products of ProductClass from the product pool, returns how many were placed.
+    // Used by the startup stocking service for shelves that start fully stocked.
+    int32 FillInitialStock(int32 MaxCount);
+
+    // Server only: places up to Count pooled units of InProductClass, clearing the shelf first if it holds another product.
+    // Backs stocking requests from clients, whose product boxes only exist locally.
+    int32 StockFromPool(TSubclassOf<AProduct> InProductClass, int32 Count);
+
     UFUNCTION(BlueprintCallable, Category = "Shelf")
     bool IsSpotEmpty(const FVector& RelativeLocation) const;
 
@@ -90,8 +165,11 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Shelf")
     bool GetNextProductLocation(FVector& OutLocation) const;
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
     UPROPERTY()
@@ -104,6 +182,29 @@ private:
     FTimerHandle ContinuousStockingTimerHandle;
     FTimerHandle StockingTimerHandle;
     void StockNextProduct();
+    FVector GetSlotRelativeLocation(int32 SlotIndex) const;
+    void RevealNextStockedProduct();
+    // Keeps the catalog's stock count for the product's SKU in sync with this shelf
+    // and wakes the shelf from net dormancy so clients get the changed slots
+    void ReportStockChange(const AProduct* Product, int32 Delta);
+
+    // Stock as seen by clients. The shelf is dormant and sends nothing while it does not change.
+    UPROPERTY(Replicated)
+    FShelfSlotArray StockSlots;
+
+    // Client side stand-ins for the products, one instanced mesh per SKU on the shelf
+    UPROPERTY(Transient)
+    TMap<FName, UInstancedStaticMeshComponent*> StockInstances;
+
+    // Units per SKU this shelf has added to the client's catalog, taken back out when the slots change or the shelf goes away
+    TMap<FName, int32> ClientCatalogStock;
+
+    friend struct FShelfSlotArray;
+    void RebuildStockVisuals();
+    void UpdateClientCatalogStock(UProductCatalog* Catalog, const TMap<FName, int32>& NewStock);
+    UPROPERTY()
+    TArray<AProduct*> ProductsPendingReveal;
+    FTimerHandle RevealTimerHandle;
 
     bool bIsStocking;
 };
\ No newline at end of file
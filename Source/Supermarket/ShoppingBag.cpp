@@ -1,72 +1,91 @@
 // ShoppingBag.cpp
 #include "ShoppingBag.h"
+#include "ProductPool.h"
+#include "SupermarketGameState.h"
+#include "Engine/World.h"
 
 UShoppingBag::UShoppingBag()
 {
     PrimaryComponentTick.bCanEverTick = false;
+
+    ProductCount = 0;
+    TotalCents = 0;
 }
 
 void UShoppingBag::AddProduct(AProduct* Product)
 {
-    if (Product)
+    if (!Product)
     {
-        Products.Add(Product);
-        UE_LOG(LogTemp, Display, TEXT("Added product to bag: %s"), *Product->GetProductName());
+        return;
     }
-}
 
-TArray<AProduct*> UShoppingBag::GetProducts() const
-{
-    return Products;
-}
+    const FName SKU = Product->GetSKU();
+    const int64 UnitCents = ASupermarketGameState::ToCents(Product->GetPrice());
 
-int32 UShoppingBag::GetProductCount() const
-{
-    return Products.Num();
+    // A basket holds a handful of SKUs, a linear search beats hashing here
+    FShoppingBagItem* Item = Items.FindByPredicate([SKU](const FShoppingBagItem& Existing) { return Existing.SKU == SKU; });
+    if (!Item)
+    {
+        Item = &Items.AddDefaulted_GetRef();
+        Item->SKU = SKU;
+        Item->ProductClass = Product->GetClass();
+        Item->UnitCents = UnitCents;
+    }
+    Item->Quantity++;
+    ProductCount++;
+    TotalCents += UnitCents;
+
+    UE_LOG(LogTemp, Display, TEXT("Added product to bag: %s"), *Product->GetProductName());
+
+    ASupermarketGameState* GameState = GetWorld() ? GetWorld()->GetGameState<ASupermarketGameState>() : nullptr;
+    if (GameState && GameState->GetProductPool())
+    {
+        GameState->GetProductPool()->Release(Product);
+    }
+    else
+    {
+        Product->Destroy();
+    }
 }
 
 void UShoppingBag::EmptyBag()
 {
-    Products.Empty();
+    Items.Reset();
+    ProductCount = 0;
+    TotalCents = 0;
 }
 
-float UShoppingBag::GetTotalCost() const
+int32 UShoppingBag::MaterializeProducts(const FTransform& Transform, TArray<AProduct*>& OutProducts) const
 {
-    float TotalCost = 0.0f;
-    for (const auto& Product : Products)
+    ASupermarketGameState* GameState = GetWorld() ? GetWorld()->GetGameState<ASupermarketGameState>() : nullptr;
+    UProductPool* Pool = GameState ? GameState->GetProductPool() : nullptr;
+    if (!Pool)
     {
-        if (Product)
-        {
-            TotalCost += Product->GetPrice();
-        }
+        UE_LOG(LogTemp, Warning, TEXT("ShoppingBag: No product pool to materialize products from"));
+        return 0;
     }
-    return TotalCost;
-}
 
-void UShoppingBag::DestroyProducts()
-{
-    for (auto& Product : Products)
+    const int32 StartNum = OutProducts.Num();
+    OutProducts.Reserve(StartNum + ProductCount);
+    for (const FShoppingBagItem& Item : Items)
     {
-        if (Product)
+        for (int32 i = 0; i < Item.Quantity; i++)
         {
-            Product->Destroy();
+            if (AProduct* Product = Pool->Acquire(Item.ProductClass, Transform))
+            {
+                OutProducts.Add(Product);
+            }
         }
     }
-    Products.Empty();
+    return OutProducts.Num() - StartNum;
 }
 
 void UShoppingBag::DebugPrintContents() const
 {
     UE_LOG(LogTemp, Display, TEXT("Shopping Bag Contents:"));
-    for (const auto& Product : Products)
+    for (const FShoppingBagItem& Item : Items)
     {
-        if (Product)
-        {
-            UE_LOG(LogTemp, Display, TEXT("- %s (Price: %.2f)"), *Product->GetProductName(), Product->GetPrice());
-        }
-        else
-        {
-            UE_LOG(LogTemp, Warning, TEXT("- Null product in bag"));
-        }
+        UE_LOG(LogTemp, Display, TEXT("- %s x%d (Price: %.2f)"), *Item.SKU.ToString(), Item.Quantity, Item.UnitCents / 100.0f);
     }
-}
\ No newline at end of file
+    UE_LOG(LogTemp, Display, TEXT("Total: %d items, %.2f"), ProductCount, TotalCents / 100.0f);
+}
@@ -6,6 +6,26 @@
 #include "Product.h"
 #include "ShoppingBag.generated.h"
 
+// One SKU in a bag
+USTRUCT(BlueprintType)
+struct FShoppingBagItem
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Shopping")
+    FName SKU;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Shopping")
+    TSubclassOf<AProduct> ProductClass;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Shopping")
+    int32 Quantity = 0;
+
+    int64 UnitCents = 0;
+};
+
+// What a customer is carrying, as SKU and quantity records with a running total. Products put in the bag
+// go back to the product pool right away, MaterializeProducts brings them back as actors at the checkout.
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class SUPERMARKET_API UShoppingBag : public UActorComponent
 {
@@ -14,25 +34,35 @@ class SUPERMARKET_API UShoppingBag : public UActorComponent
 public:
     UShoppingBag();
 
+    // Records the product and releases its actor
     UFUNCTION(BlueprintCallable, Category = "Shopping")
     void AddProduct(AProduct* Product);
+
     UFUNCTION(BlueprintCallable, Category = "Shopping")
-    void DestroyProducts();
-    UFUNCTION(BlueprintCallable, Category = "Shopping")
-    TArray<AProduct*> GetProducts() const;
+    const TArray<FShoppingBagItem>& GetItems() const { return Items; }
 
+    // Number of units, not SKUs
     UFUNCTION(BlueprintCallable, Category = "Shopping")
-    int32 GetProductCount() const;
+    int32 GetProductCount() const { return ProductCount; }
 
     UFUNCTION(BlueprintCallable, Category = "Shopping")
     void EmptyBag();
 
     UFUNCTION(BlueprintCallable, Category = "Shopping")
-    float GetTotalCost() const;
+    float GetTotalCost() const { return TotalCents / 100.0f; }
+
+    int64 GetTotalCents() const { return TotalCents; }
+
+    // Takes one actor per unit from the product pool, placed at Transform. The bag keeps its records.
+    int32 MaterializeProducts(const FTransform& Transform, TArray<AProduct*>& OutProducts) const;
 
     UFUNCTION(BlueprintCallable, Category = "Shopping")
     void DebugPrintContents() const;
+
 private:
     UPROPERTY()
-    TArray<AProduct*> Products;
-};
\ No newline at end of file
+    TArray<FShoppingBagItem> Items;
+
+    int32 ProductCount;
+    int64 TotalCents;
+};
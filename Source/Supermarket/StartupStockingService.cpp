@@ -0,0 +1,115 @@
+// StartupStockingService.cpp
+#include "StartupStockingService.h"
+#include "Shelf.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "HAL/PlatformTime.h"
+
+UStartupStockingService::UStartupStockingService()
+{
+    MaxMillisecondsPerFrame = 2.0f;
+    ProductsPerStep = 5;
+
+    bStarted = false;
+    bSliceScheduled = false;
+    bNeedsSort = false;
+    bStoreReady = false;
+    ProductsStocked = 0;
+    StartTime = 0.0;
+}
+
+void UStartupStockingService::RegisterShelf(AShelf* Shelf)
+{
+    if (!Shelf)
+    {
+        return;
+    }
+
+    PendingShelves.AddUnique(Shelf);
+    bNeedsSort = true;
+
+    // Shelves streamed in later are filled the same way
+    if (bStarted)
+    {
+        ScheduleSlice();
+    }
+}
+
+void UStartupStockingService::Start()
+{
+    if (bStarted)
+    {
+        return;
+    }
+
+    bStarted = true;
+    StartTime = FPlatformTime::Seconds();
+    ScheduleSlice();
+}
+
+void UStartupStockingService::ScheduleSlice()
+{
+    UWorld* World = GetWorld();
+    if (!bSliceScheduled && World)
+    {
+        bSliceScheduled = true;
+        World->GetTimerManager().SetTimerForNextTick(this, &UStartupStockingService::ProcessSlice);
+    }
+}
+
+void UStartupStockingService::ProcessSlice()
+{
+    bSliceScheduled = false;
+
+    if (bNeedsSort)
+    {
+        SortByDistanceToPlayer();
+        bNeedsSort = false;
+    }
+
+    const double SliceEnd = FPlatformTime::Seconds() + MaxMillisecondsPerFrame / 1000.0;
+    while (PendingShelves.Num() > 0 && FPlatformTime::Seconds() < SliceEnd)
+    {
+        AShelf* Shelf = PendingShelves.Last().Get();
+        const int32 Added = Shelf ? Shelf->FillInitialStock(ProductsPerStep) : 0;
+        ProductsStocked += Added;
+
+        // Full, or nothing more can be placed on it
+        if (Added < ProductsPerStep)
+        {
+            PendingShelves.Pop(false);
+        }
+    }
+
+    if (PendingShelves.Num() > 0)
+    {
+        ScheduleSlice();
+        return;
+    }
+
+    if (!bStoreReady)
+    {
+        bStoreReady = true;
+        UE_LOG(LogTemp, Display, TEXT("StartupStocking: Store ready, %d products stocked in %.2fs"),
+            ProductsStocked, FPlatformTime::Seconds() - StartTime);
+        OnStoreReady.Broadcast();
+    }
+}
+
+void UStartupStockingService::SortByDistanceToPlayer()
+{
+    const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+    if (!PlayerPawn)
+    {
+        return;
+    }
+
+    const FVector PlayerLocation = PlayerPawn->GetActorLocation();
+    PendingShelves.Sort([&PlayerLocation](const TWeakObjectPtr<AShelf>& A, const TWeakObjectPtr<AShelf>& B)
+    {
+        const float DistA = A.IsValid() ? FVector::DistSquared(A->GetActorLocation(), PlayerLocation) : 0.0f;
+        const float DistB = B.IsValid() ? FVector::DistSquared(B->GetActorLocation(), PlayerLocation) : 0.0f;
+        return DistA > DistB;
+    });
+}
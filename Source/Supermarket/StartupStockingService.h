@@ -0,0 +1,57 @@
+// StartupStockingService.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "StartupStockingService.generated.h"
+
+class AShelf;
+
+// Fills the shelves that start fully stocked over several frames instead of all inside BeginPlay.
+// Each frame it stocks shelves, nearest to the player first, until MaxMillisecondsPerFrame is used up.
+// OnStoreReady fires once the first batch of registered shelves is full.
+UCLASS()
+class SUPERMARKET_API UStartupStockingService : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UStartupStockingService();
+
+    // Queues the shelf for its initial fill
+    void RegisterShelf(AShelf* Shelf);
+
+    // Called by the game state once play has begun, shelves registered in the same frame are picked up
+    void Start();
+
+    UFUNCTION(BlueprintCallable, Category = "Stocking")
+    bool IsStoreReady() const { return bStoreReady; }
+
+    UFUNCTION(BlueprintCallable, Category = "Stocking")
+    int32 GetNumPendingShelves() const { return PendingShelves.Num(); }
+
+    FSimpleMulticastDelegate OnStoreReady;
+
+    // Time spent stocking per frame
+    UPROPERTY(EditAnywhere, Category = "Stocking", meta = (ClampMin = "0.1"))
+    float MaxMillisecondsPerFrame;
+
+    // Products placed per shelf call, the budget is checked between calls
+    UPROPERTY(EditAnywhere, Category = "Stocking", meta = (ClampMin = "1"))
+    int32 ProductsPerStep;
+
+private:
+    void ScheduleSlice();
+    void ProcessSlice();
+    void SortByDistanceToPlayer();
+
+    // Sorted farthest first so the nearest shelf is popped off the end
+    TArray<TWeakObjectPtr<AShelf>> PendingShelves;
+
+    bool bStarted;
+    bool bSliceScheduled;
+    bool bNeedsSort;
+    bool bStoreReady;
+    int32 ProductsStocked;
+    double StartTime;
+};
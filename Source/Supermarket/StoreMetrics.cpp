@@ -0,0 +1,129 @@
+// StoreMetrics.cpp
+#include "StoreMetrics.h"
+#include "SupermarketGameState.h"
+#include "AICustomerPawn.h"
+#include "Engine/World.h"
+
+UStoreMetrics* UStoreMetrics::Get(const UWorld* World)
+{
+    const ASupermarketGameState* GameState = World ? World->GetGameState<ASupermarketGameState>() : nullptr;
+    return GameState ? GameState->GetStoreMetrics() : nullptr;
+}
+
+void UStoreMetrics::RecordCustomerEntered(const AAICustomerPawn* Customer)
+{
+    if (!Customer || Visits.Contains(Customer))
+    {
+        return;
+    }
+
+    Visits.Add(Customer).EnterTime = GetTime();
+    CustomersEntered++;
+}
+
+void UStoreMetrics::RecordCustomerLeft(const AAICustomerPawn* Customer)
+{
+    FCustomerVisit Visit;
+    if (!Customer || !Visits.RemoveAndCopyValue(Customer, Visit))
+    {
+        return;
+    }
+
+    if (Visit.bServed)
+    {
+        TimesInStore.Add(GetTime() - Visit.EnterTime);
+    }
+    else
+    {
+        CustomersLeftUnserved++;
+    }
+}
+
+void UStoreMetrics::RecordFailedPick(const AAICustomerPawn* Customer)
+{
+    FailedPicks++;
+}
+
+void UStoreMetrics::RecordNavigationFailure(const AAICustomerPawn* Customer)
+{
+    NavigationFailures++;
+}
+
+void UStoreMetrics::RecordQueueJoined(const AAICustomerPawn* Customer)
+{
+    if (Customer)
+    {
+        FindOrAddVisit(Customer).QueueJoinTime = GetTime();
+    }
+}
+
+void UStoreMetrics::RecordServiceStarted(const AAICustomerPawn* Customer)
+{
+    FCustomerVisit* Visit = Customer ? Visits.Find(Customer) : nullptr;
+    if (Visit && Visit->QueueJoinTime >= 0.0f)
+    {
+        QueueWaits.Add(GetTime() - Visit->QueueJoinTime);
+        Visit->QueueJoinTime = -1.0f;
+    }
+}
+
+void UStoreMetrics::RecordCustomerServed(const AAICustomerPawn* Customer)
+{
+    if (!Customer)
+    {
+        return;
+    }
+
+    FCustomerVisit& Visit = FindOrAddVisit(Customer);
+    if (!Visit.bServed)
+    {
+        Visit.bServed = true;
+        CustomersServed++;
+    }
+}
+
+void UStoreMetrics::Reset()
+{
+    Visits.Reset();
+    TimesInStore.Reset();
+    QueueWaits.Reset();
+    CustomersEntered = 0;
+    CustomersServed = 0;
+    CustomersLeftUnserved = 0;
+    FailedPicks = 0;
+    NavigationFailures = 0;
+}
+
+float UStoreMetrics::Percentile(const TArray<float>& Values, float Percent)
+{
+    if (Values.Num() == 0)
+    {
+        return 0.0f;
+    }
+
+    TArray<float> Sorted = Values;
+    Sorted.Sort();
+
+    const int32 Rank = FMath::CeilToInt(FMath::Clamp(Percent, 0.0f, 100.0f) / 100.0f * Sorted.Num());
+    return Sorted[FMath::Clamp(Rank - 1, 0, Sorted.Num() - 1)];
+}
+
+UStoreMetrics::FCustomerVisit& UStoreMetrics::FindOrAddVisit(const AAICustomerPawn* Customer)
+{
+    // Customers placed in the level may never have called StartShopping, they count from their first report
+    if (FCustomerVisit* Visit = Visits.Find(Customer))
+    {
+        return *Visit;
+    }
+
+    CustomersEntered++;
+    FCustomerVisit& Visit = Visits.Add(Customer);
+    Visit.EnterTime = GetTime();
+    return Visit;
+}
+
+float UStoreMetrics::GetTime() const
+{
+    const UWorld* World = GetWorld();
+    return World ? World->GetTimeSeconds() : 0.0f;
+}
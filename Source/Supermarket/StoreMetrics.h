@@ -0,0 +1,77 @@
+// StoreMetrics.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
+#include "StoreMetrics.generated.h"
+
+class AAICustomerPawn;
+
+// Counters and per-customer timings of the store's shopping loop, read by USupermarketSimCommandlet for its
+// throughput report. Customers and checkouts report what happens to them here. Times are world (game) seconds.
+UCLASS()
+class SUPERMARKET_API UStoreMetrics : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // The metrics of the world's supermarket game state, null in other game modes
+    static UStoreMetrics* Get(const UWorld* World);
+
+    void RecordCustomerEntered(const AAICustomerPawn* Customer);
+    void RecordCustomerLeft(const AAICustomerPawn* Customer);
+
+    // A customer arrived at a shelf and found nothing left to take
+    void RecordFailedPick(const AAICustomerPawn* Customer);
+
+    // A customer gave up on a move, either without a path or after failing to arrive
+    void RecordNavigationFailure(const AAICustomerPawn* Customer);
+
+    void RecordQueueJoined(const AAICustomerPawn* Customer);
+
+    // A checkout station was assigned, ends the customer's queue wait
+    void RecordServiceStarted(const AAICustomerPawn* Customer);
+
+    void RecordCustomerServed(const AAICustomerPawn* Customer);
+
+    void Reset();
+
+    int32 GetCustomersEntered() const { return CustomersEntered; }
+    int32 GetCustomersServed() const { return CustomersServed; }
+    int32 GetCustomersLeftUnserved() const { return CustomersLeftUnserved; }
+    int32 GetCustomersInStore() const { return Visits.Num(); }
+    int32 GetFailedPicks() const { return FailedPicks; }
+    int32 GetNavigationFailures() const { return NavigationFailures; }
+
+    // Entry to exit of every customer that paid
+    const TArray<float>& GetTimesInStore() const { return TimesInStore; }
+
+    // Queue join to station assignment
+    const TArray<float>& GetQueueWaits() const { return QueueWaits; }
+
+    // Nearest-rank percentile (0-100) of Values, 0 for an empty array
+    static float Percentile(const TArray<float>& Values, float Percent);
+
+private:
+    struct FCustomerVisit
+    {
+        float EnterTime = 0.0f;
+        float QueueJoinTime = -1.0f;
+        bool bServed = false;
+    };
+
+    FCustomerVisit& FindOrAddVisit(const AAICustomerPawn* Customer);
+    float GetTime() const;
+
+    TMap<TObjectKey<AAICustomerPawn>, FCustomerVisit> Visits;
+
+    TArray<float> TimesInStore;
+    TArray<float> QueueWaits;
+
+    int32 CustomersEntered = 0;
+    int32 CustomersServed = 0;
+    int32 CustomersLeftUnserved = 0;
+    int32 FailedPicks = 0;
+    int32 NavigationFailures = 0;
+};
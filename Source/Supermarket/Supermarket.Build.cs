@@ -9,8 +9,8 @@ public class Supermarket : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "NavigationSystem", "AIModule" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "NavigationSystem", "AIModule", "NetCore", "SupermarketSim" });
 
-        PrivateDependencyModuleNames.AddRange(new string[] { "UMG" });  // Add UMG here
+        PrivateDependencyModuleNames.AddRange(new string[] { "UMG", "Json", "ReplicationGraph" });  // Add UMG here
     }
 }
@@ -3,3 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+// Trace channel for things the player can focus and use (shelves, boxes, checkouts), see DefaultEngine.ini.
+// Ignored by default so products and level geometry don't get in the way of the interaction trace.
+#define ECC_Interactable ECC_GameTraceChannel2
+
+// Object channel of every product, see the ProductShelved and ProductLoose profiles in DefaultEngine.ini.
+// Nothing else responds to it, so shelf slot checks only ever look at products.
+#define ECC_Product ECC_GameTraceChannel3
@@ -15,6 +15,9 @@
 #include "Blueprint/UserWidget.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/WidgetComponent.h"
+#include "TabletWidgetComponent.h"
+#include "InteractionComponent.h"
+#include "BackRoomInventory.h"
 #include "Blueprint/UserWidget.h"
 #include "GameFramework/CharacterMovementComponent.h"
 
@@ -41,9 +44,15 @@ ASupermarketCharacter::ASupermarketCharacter()
     TabletCameraComponent->bUsePawnControlRotation = false;
     TabletCameraComponent->SetActive(false); // Start with this camera inactive
 
+    // Async focus trace, replaces the per-action line traces
+    InteractionComponent = CreateDefaultSubobject<UInteractionComponent>(TEXT("InteractionComponent"));
+
     ProductBoxOffset = FVector(90.0f, 0.0f, -60.0f);
     ProductBoxRotation = FRotator(0.0f, 90.0f, 0.0f);
 
+    // The server and other players never look at this mesh closely enough to need its pose
+    GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+
     HeldProductBox = nullptr;
     CurrentTargetShelf = nullptr;
     bIsInteracting = false;
@@ -59,7 +68,7 @@ ASupermarketCharacter::ASupermarketCharacter()
     TabletScreenOffset = FVector(0, 0, 5);
     TabletScreenRotation = FRotator(90.0f, 0.0f, 0.0f);
 
-    TabletScreenWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("TabletScreenWidget"));
+    TabletScreenWidget = CreateDefaultSubobject<UTabletWidgetComponent>(TEXT("TabletScreenWidget"));
     TabletScreenWidget->SetupAttachment(TabletMesh);
     TabletScreenWidget->SetRelativeLocation(FVector(0.0f, 0.0f, 5.0f)); // Adjust as needed
     TabletScreenWidget->SetRelativeRotation(FRotator(0.0f, 0.0f, 180.0f)); // Face the widget towards the player
@@ -92,18 +101,24 @@ void ASupermarketCharacter::Tick(float DeltaTime)
     {
         UpdateCameraTransition();
     }
-
-    UpdateProductBoxTransform();
 }
 
 void ASupermarketCharacter::BeginPlay()
 {
     // Call the base class  
     Super::BeginPlay();
-    CreateMoneyDisplayWidget();
+    InteractionComponent->SetTraceOrigin(FirstPersonCameraComponent);
+    InteractionComponent->OnFocusChanged.AddUObject(this, &ASupermarketCharacter::OnFocusChanged);
     OriginalCameraRotation = FirstPersonCameraComponent->GetRelativeRotation();
     OriginalCameraFOV = FirstPersonCameraComponent->FieldOfView;
-    SetupTabletScreen();
+
+    // HUD and tablet screen only exist for the player at this machine, never on a server or for remote players.
+    // Clients are usually possessed after BeginPlay, NotifyControllerChanged covers that case.
+    if (IsLocallyControlled() && !MoneyDisplayWidget)
+    {
+        CreateMoneyDisplayWidget();
+        SetupTabletScreen();
+    }
     if (Controller)
     {
         OriginalControllerRotation = Controller->GetControlRotation();
@@ -183,7 +198,7 @@ void ASupermarketCharacter::SetupTabletMode(bool bEnable)
         }
         if (TabletScreenWidget)
         {
-            TabletScreenWidget->SetVisibility(true);
+            TabletScreenWidget->SetStowed(false);
         }
 
         // Disable character movement
@@ -215,7 +230,8 @@ void ASupermarketCharacter::SetupTabletMode(bool bEnable)
         }
         if (TabletScreenWidget)
         {
-            TabletScreenWidget->SetVisibility(false);
+            // Hides the screen and frees its render target until the tablet comes out again
+            TabletScreenWidget->SetStowed(true);
         }
 
         // Enable character movement
@@ -367,14 +383,13 @@ void ASupermarketCharacter::StartStocking()
     if (HeldProductBox)  // Only start stocking if holding a product box
     {
         bIsStocking = true;
-        GetWorldTimerManager().SetTimer(StockingTimerHandle, this, &ASupermarketCharacter::CheckShelfInView, 0.1f, true);
+        CheckShelfInView();
     }
 }
 
 void ASupermarketCharacter::StopStocking()
 {
     bIsStocking = false;
-    GetWorldTimerManager().ClearTimer(StockingTimerHandle);
     if (CurrentTargetShelf)
     {
         CurrentTargetShelf->StopStockingShelf();
@@ -384,12 +399,19 @@ void ASupermarketCharacter::StopStocking()
     // Check if the ProductBox is empty and destroy it if necessary
     if (HeldProductBox && HeldProductBox->IsEmpty())
     {
+        InteractionComponent->RemoveIgnoredActor(HeldProductBox);
         HeldProductBox->Destroy();
         HeldProductBox = nullptr;
     }
 }
 
-
+void ASupermarketCharacter::OnFocusChanged(AActor* OldFocus, AActor* NewFocus)
+{
+    if (bIsStocking)
+    {
+        CheckShelfInView();
+    }
+}
 
 void ASupermarketCharacter::CheckShelfInView()
 {
@@ -398,52 +420,41 @@ void ASupermarketCharacter::CheckShelfInView()
         return;
     }
 
-    FVector Start = FirstPersonCameraComponent->GetComponentLocation();
-    FVector End = Start + FirstPersonCameraComponent->GetForwardVector() * 300.0f;
+    AShelf* HitShelf = InteractionComponent->GetFocus<AShelf>();
+    if (HitShelf == CurrentTargetShelf)
+    {
+        return;
+    }
 
-    FHitResult HitResult;
-    FCollisionQueryParams QueryParams;
-    QueryParams.AddIgnoredActor(this);
+    if (CurrentTargetShelf)
+    {
+        CurrentTargetShelf->StopStockingShelf();
+        CurrentTargetShelf = nullptr;
+    }
 
-    if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams))
+    if (HitShelf)
     {
-        AShelf* HitShelf = Cast<AShelf>(HitResult.GetActor());
-        if (HitShelf)
+        if (!HasAuthority() && !HeldProductBox->IsEmpty())
         {
-            if (HitShelf != CurrentTargetShelf)
+            // No stocking timer on a client, the server fills what fits in one request
+            const int32 Count = FMath::Min(HeldProductBox->GetProductCount(), HitShelf->GetRemainingCapacity());
+            if (Count > 0)
             {
-                if (CurrentTargetShelf)
-                {
-                    CurrentTargetShelf->StopStockingShelf();
-                }
-                CurrentTargetShelf = HitShelf;
-                if (!HeldProductBox->IsEmpty())
-                {
-                    CurrentTargetShelf->SetProductBox(HeldProductBox);
-                    CurrentTargetShelf->StartStockingShelf(HeldProductBox->GetProductClass());
-                }
-                else
-                {
-                    // ProductBox is empty, stop stocking
-                    StopStocking();
-                }
+                ServerStockShelf(HitShelf, HeldProductBox->GetProductClass(), Count);
+                HeldProductBox->DiscardProducts(Count);
             }
+            CurrentTargetShelf = HitShelf;
         }
-        else
+        else if (!HeldProductBox->IsEmpty())
         {
-            if (CurrentTargetShelf)
-            {
-                CurrentTargetShelf->StopStockingShelf();
-                CurrentTargetShelf = nullptr;
-            }
+            CurrentTargetShelf = HitShelf;
+            CurrentTargetShelf->SetProductBox(HeldProductBox);
+            CurrentTargetShelf->StartStockingShelf(HeldProductBox->GetProductClass());
         }
-    }
-    else
-    {
-        if (CurrentTargetShelf)
+        else
         {
-            CurrentTargetShelf->StopStockingShelf();
-            CurrentTargetShelf = nullptr;
+            // ProductBox is empty, stop stocking
+            StopStocking();
         }
     }
 }
@@ -487,20 +498,15 @@ void ASupermarketCharacter::OnInteract()
         return;
     }
 
-    // Try to pick up a box
-    FVector Start = FirstPersonCameraComponent->GetComponentLocation();
-    FVector End = Start + FirstPersonCameraComponent->GetForwardVector() * 300.0f;
-
-    FHitResult HitResult;
-    FCollisionQueryParams QueryParams;
-    QueryParams.AddIgnoredActor(this);
-
-    if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, QueryParams))
+    // Try to pick up the box the player is looking at
+    if (AProductBox* ProductBox = InteractionComponent->GetFocus<AProductBox>())
     {
-        if (AProductBox* ProductBox = Cast<AProductBox>(HitResult.GetActor()))
-        {
-            PickUpProductBox(ProductBox);
-        }
+        PickUpProductBox(ProductBox);
+    }
+    else if (ABackRoomInventory* BackRoom = InteractionComponent->GetFocus<ABackRoomInventory>())
+    {
+        // Stockroom boxes are only records until someone takes one
+        PickUpProductBox(BackRoom->TakeBox(InteractionComponent->GetFocusHit().Item));
     }
 }
 
@@ -520,6 +526,9 @@ void ASupermarketCharacter::PickUpProductBox(AProductBox* ProductBox)
     {
         HeldProductBox = ProductBox;
 
+        // The carried box sits right in front of the camera, look past it
+        InteractionComponent->AddIgnoredActor(HeldProductBox);
+
         // Disable physics simulation
         UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(HeldProductBox->GetRootComponent());
         if (PrimitiveComponent)
@@ -543,6 +552,7 @@ void ASupermarketCharacter::DropProductBox()
     if (HeldProductBox)
     {
         HeldProductBox->DetachFromCamera();
+        InteractionComponent->RemoveIgnoredActor(HeldProductBox);
 
         // Re-enable physics simulation
         UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(HeldProductBox->GetRootComponent());
@@ -560,7 +570,19 @@ void ASupermarketCharacter::DropProductBox()
 
 void ASupermarketCharacter::InteractWithShelf(AShelf* Shelf)
 {
-    if (Shelf && HeldProductBox)
+    if (Shelf && HeldProductBox && !HasAuthority())
+    {
+        ServerStockShelf(Shelf, HeldProductBox->GetProductClass(), 1);
+
+        // The unit is now on the shelf, the box only has to count it out
+        HeldProductBox->DiscardProducts(1);
+        if (HeldProductBox->GetProductCount() == 0)
+        {
+            HeldProductBox->Destroy();
+            HeldProductBox = nullptr;
+        }
+    }
+    else if (Shelf && HeldProductBox)
     {
         TSubclassOf<AProduct> BoxProductClass = HeldProductBox->GetProductClass();
         TSubclassOf<AProduct> ShelfProductClass = Shelf->GetCurrentProductClass();
@@ -570,12 +592,8 @@ void ASupermarketCharacter::InteractWithShelf(AShelf* Shelf)
             // Start stocking the shelf
             Shelf->StartStockingShelf(BoxProductClass);
 
-            // Remove a product from the box
-            AProduct* RemovedProduct = HeldProductBox->RemoveProduct();
-            if (RemovedProduct)
-            {
-                RemovedProduct->Destroy(); // Destroy the product as it's now on the shelf
-            }
+            // The unit is now on the shelf, the box only has to count it out
+            HeldProductBox->DiscardProducts(1);
 
             // If the box is empty, destroy it
             if (HeldProductBox->GetProductCount() == 0)
@@ -593,12 +611,8 @@ void ASupermarketCharacter::InteractWithShelf(AShelf* Shelf)
             }
             Shelf->StartStockingShelf(BoxProductClass);
 
-            // Remove a product from the box
-            AProduct* RemovedProduct = HeldProductBox->RemoveProduct();
-            if (RemovedProduct)
-            {
-                RemovedProduct->Destroy(); // Destroy the product as it's now on the shelf
-            }
+            // The unit is now on the shelf, the box only has to count it out
+            HeldProductBox->DiscardProducts(1);
 
             // If the box is empty, destroy it
             if (HeldProductBox->GetProductCount() == 0)
@@ -610,6 +624,28 @@ void ASupermarketCharacter::InteractWithShelf(AShelf* Shelf)
     }
 }
 
+void ASupermarketCharacter::ServerStockShelf_Implementation(AShelf* Shelf, TSubclassOf<AProduct> ProductClass, int32 Count)
+{
+    if (!Shelf || !ProductClass || Count <= 0)
+    {
+        return;
+    }
+
+    const int32 Added = Shelf->StockFromPool(ProductClass, Count);
+    UE_LOG(LogTemp, Display, TEXT("%s stocked %d of %d requested products on %s"), *GetName(), Added, Count, *Shelf->GetName());
+}
+
+void ASupermarketCharacter::NotifyControllerChanged()
+{
+    Super::NotifyControllerChanged();
+
+    if (HasActorBegunPlay() && IsLocallyControlled() && !MoneyDisplayWidget)
+    {
+        CreateMoneyDisplayWidget();
+        SetupTabletScreen();
+    }
+}
+
 void ASupermarketCharacter::SetupTabletScreen()
 {
     if (TabletWidgetClass && TabletScreenWidget)
@@ -670,6 +706,11 @@ void ASupermarketCharacter::OnTabletClickInput()
             FVector2D MousePosition;
             if (PC->GetMousePosition(MousePosition.X, MousePosition.Y))
             {
+                // The click may change what the screen shows, draw it once the UI has handled it
+                if (TabletScreenWidget)
+                {
+                    TabletScreenWidget->RequestRedraw();
+                }
                 OnTabletClicked(MousePosition);
             }
         }
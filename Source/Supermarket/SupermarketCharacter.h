@@ -17,6 +17,7 @@ class UCameraComponent;
 class UInputAction;
 class UInputMappingContext;
 class UWidgetComponent;
+class UTabletWidgetComponent;
 class UUserWidget;
 struct FInputActionValue;
 
@@ -29,7 +30,7 @@ class ASupermarketCharacter : public ACharacter
 
     /** Tablet Screen Widget Component */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Tablet, meta = (AllowPrivateAccess = "true"))
-    UWidgetComponent* TabletScreenWidget;
+    UTabletWidgetComponent* TabletScreenWidget;
 
 
     // Add this function declaration if you want to be able to update the transform at runtime
@@ -72,6 +73,10 @@ class ASupermarketCharacter : public ACharacter
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
     UCameraComponent* FirstPersonCameraComponent;
 
+    /** Tracks what the player is looking at */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Interaction, meta = (AllowPrivateAccess = "true"))
+    class UInteractionComponent* InteractionComponent;
+
     /** Tablet view camera */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
     UCameraComponent* TabletCameraComponent;
@@ -131,6 +136,10 @@ public:
 
     UFUNCTION(BlueprintCallable, Category = "Interaction")
     void StopStocking();
+
+    // Shelf stock is server state. A client counts units out of its local box and asks the server to shelve them.
+    UFUNCTION(Server, Reliable)
+    void ServerStockShelf(AShelf* Shelf, TSubclassOf<AProduct> ProductClass, int32 Count);
     UFUNCTION(BlueprintCallable, Category = "Tablet")
     void SetTabletScreenContent(TSubclassOf<UUserWidget> NewWidgetClass);
 
@@ -186,6 +195,7 @@ protected:
 protected:
     // APawn interface
     virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
+    virtual void NotifyControllerChanged() override;
     // End of APawn interface
     virtual void Tick(float DeltaTime) override;
     /** Called for tablet input */
@@ -219,8 +229,8 @@ private:
     bool bIsStocking;
     FRotator OriginalControllerRotation;
     void CheckShelfInView();
+    void OnFocusChanged(AActor* OldFocus, AActor* NewFocus);
     bool bCameraRotationEnabled;
-    FTimerHandle StockingTimerHandle;
     UPROPERTY()
     AProductBox* HeldProductBox;
     bool bIsInteracting;
@@ -1,27 +1,253 @@
 // SupermarketGameState.cpp
 #include "SupermarketGameState.h"
+#include "ProductCatalog.h"
+#include "ProductPool.h"
+#include "StartupStockingService.h"
+#include "ProductDeliveryService.h"
+#include "StoreMetrics.h"
+#include "Product.h"
+#include "GameFramework/WorldSettings.h"
 #include "Net/UnrealNetwork.h"
+#include "Engine/World.h"
+#include "Misc/Paths.h"
 
 ASupermarketGameState::ASupermarketGameState()
 {
-    TotalMoney = 0.0f;
+    TotalCents = 0;
+
+    // Created with the game state so shelves can report stock no matter which BeginPlay runs first
+    ProductCatalog = CreateDefaultSubobject<UProductCatalog>(TEXT("ProductCatalog"));
+    ProductPool = CreateDefaultSubobject<UProductPool>(TEXT("ProductPool"));
+    StartupStocking = CreateDefaultSubobject<UStartupStockingService>(TEXT("StartupStocking"));
+    DeliveryService = CreateDefaultSubobject<UProductDeliveryService>(TEXT("DeliveryService"));
+    StoreMetrics = CreateDefaultSubobject<UStoreMetrics>(TEXT("StoreMetrics"));
+    MaxRecentTransactions = 64;
+    bWriteTransactionLog = true;
+    MaxSimulationSpeed = 50.0f;
+    MaxCosmeticSimulationSpeed = 3.0f;
+    CustomerSeeds.GenerateNewSeed();
+
+    PendingCents = 0;
+    bSettlementScheduled = false;
+    NextTransactionId = 1;
+    RecentHead = 0;
+    NumRecent = 0;
+}
+
+void ASupermarketGameState::BeginPlay()
+{
+    Super::BeginPlay();
+
+    for (TSubclassOf<AProduct> ProductClass : CatalogProductClasses)
+    {
+        ProductCatalog->RegisterProductClass(ProductClass);
+    }
+
+    // Shelves queue themselves in their own BeginPlay, the first slice runs next frame
+    StartupStocking->Start();
+
+    if (bWriteTransactionLog && HasAuthority())
+    {
+        TransactionLog = MakeUnique<FTransactionLogWriter>(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Transactions")));
+    }
+
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ASupermarketGameState::HandleWorldPostActorTick);
+}
+
+void ASupermarketGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // Settle whatever was recorded this frame so it makes it into the log, then let the writer drain and close its file
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    PostActorTickHandle.Reset();
+    if (bSettlementScheduled)
+    {
+        SettleLedger();
+    }
+    TransactionLog.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASupermarketGameState::SetSimulationSpeed(float Speed)
+{
+    AWorldSettings* WorldSettings = GetWorldSettings();
+    if (!HasAuthority() || !WorldSettings)
+    {
+        return;
+    }
+
+    Speed = FMath::Clamp(Speed, 1.0f, MaxSimulationSpeed);
+    if (FMath::IsNearlyEqual(WorldSettings->TimeDilation, Speed))
+    {
+        return;
+    }
+
+    // The world settings clamp the dilation to 20 by default
+    WorldSettings->MaxGlobalTimeDilation = FMath::Max(WorldSettings->MaxGlobalTimeDilation, MaxSimulationSpeed);
+    WorldSettings->SetTimeDilation(Speed);
+
+    UE_LOG(LogTemp, Display, TEXT("Simulation speed set to %.1fx"), Speed);
+    OnSimulationSpeedChanged.Broadcast(Speed);
+}
+
+float ASupermarketGameState::GetSimulationSpeed() const
+{
+    const AWorldSettings* WorldSettings = GetWorldSettings();
+    return WorldSettings ? WorldSettings->TimeDilation : 1.0f;
+}
+
+bool ASupermarketGameState::ShouldSkipCosmetics() const
+{
+    return GetNetMode() == NM_DedicatedServer || GetSimulationSpeed() > MaxCosmeticSimulationSpeed;
+}
+
+bool ASupermarketGameState::ShouldSkipCosmeticsIn(const UWorld* World)
+{
+    const ASupermarketGameState* GameState = World ? World->GetGameState<ASupermarketGameState>() : nullptr;
+    return GameState && GameState->ShouldSkipCosmetics();
 }
 
 void ASupermarketGameState::AddMoney(float Amount)
 {
-    TotalMoney += Amount;
-    OnRep_TotalMoney();
+    PendingCents += ToCents(Amount);
+    ScheduleSettlement();
+}
+
+void ASupermarketGameState::RecordTransaction(FSupermarketTransaction Transaction)
+{
+    Transaction.TransactionId = NextTransactionId++;
+    PendingCents += Transaction.Cents;
+    PendingTransactions.Add(MoveTemp(Transaction));
+
+    ScheduleSettlement();
+}
+
+void ASupermarketGameState::ScheduleSettlement()
+{
+    // Picked up by HandleWorldPostActorTick at the end of this frame
+    bSettlementScheduled = true;
+}
+
+void ASupermarketGameState::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+    // The delegate fires for every world, editor previews included
+    if (bSettlementScheduled && World == GetWorld())
+    {
+        SettleLedger();
+    }
+}
+
+void ASupermarketGameState::SettleLedger()
+{
+    bSettlementScheduled = false;
+
+    if (PendingCents != 0)
+    {
+        // One change of the replicated total per frame, however many sales went into it
+        TotalCents += PendingCents;
+        PendingCents = 0;
+        OnRep_TotalCents();
+    }
+
+    if (PendingTransactions.Num() == 0)
+    {
+        return;
+    }
+
+    if (RecentTransactions.Num() != MaxRecentTransactions)
+    {
+        RecentTransactions.SetNum(MaxRecentTransactions);
+        RecentHead = 0;
+        NumRecent = 0;
+    }
+
+    for (const FSupermarketTransaction& Transaction : PendingTransactions)
+    {
+        FSupermarketTransactionSummary& Summary = RecentTransactions[RecentHead];
+        Summary.TransactionId = Transaction.TransactionId;
+        Summary.CheckoutId = Transaction.CheckoutId;
+        Summary.CustomerId = Transaction.CustomerId;
+        Summary.NumItems = 0;
+        for (const FSkuCount& Line : Transaction.Items)
+        {
+            Summary.NumItems += Line.Quantity;
+        }
+        Summary.Cents = Transaction.Cents;
+        Summary.Timestamp = Transaction.Timestamp;
+        RecentHead = (RecentHead + 1) % RecentTransactions.Num();
+        NumRecent = FMath::Min(NumRecent + 1, RecentTransactions.Num());
+
+        // Only queues the records, the file is written on the log's own thread
+        if (TransactionLog)
+        {
+            TransactionLog->Append(Transaction);
+        }
+
+        SalesStore.AddTransaction(Transaction);
+    }
+
+    OnTransactionsSettled.Broadcast(PendingTransactions);
+    PendingTransactions.Reset();
+}
+
+TArray<FSupermarketTransactionSummary> ASupermarketGameState::GetRecentTransactions() const
+{
+    TArray<FSupermarketTransactionSummary> Result;
+    Result.Reserve(NumRecent);
+    for (int32 i = 1; i <= NumRecent; ++i)
+    {
+        const int32 Index = (RecentHead - i + RecentTransactions.Num()) % RecentTransactions.Num();
+        Result.Add(RecentTransactions[Index]);
+    }
+    return Result;
+}
+
+float ASupermarketGameState::GetRevenueBetween(float StartTime, float EndTime) const
+{
+    return SalesStore.GetRevenueCents(StartTime, EndTime) / 100.0f;
+}
+
+TArray<float> ASupermarketGameState::GetRevenuePerHour(int32 NumHours) const
+{
+    const float Now = GetWorld()->GetTimeSeconds();
+
+    TArray<int64> HourCents;
+    SalesStore.GetRevenuePerHour(Now - NumHours * 3600.0f, NumHours, HourCents);
+
+    TArray<float> Result;
+    Result.Reserve(HourCents.Num());
+    for (int64 Cents : HourCents)
+    {
+        Result.Add(Cents / 100.0f);
+    }
+    return Result;
+}
+
+TArray<FSkuCount> ASupermarketGameState::GetTopSellersToday(int32 Count) const
+{
+    TArray<TPair<FName, int32>> Sellers;
+    SalesStore.GetTopSellers(SalesStore.GetDay(GetWorld()->GetTimeSeconds()), Count, Sellers);
+
+    TArray<FSkuCount> Result;
+    Result.Reserve(Sellers.Num());
+    for (const TPair<FName, int32>& Seller : Sellers)
+    {
+        FSkuCount& Line = Result.AddDefaulted_GetRef();
+        Line.SKU = Seller.Key;
+        Line.Quantity = Seller.Value;
+    }
+    return Result;
 }
 
-void ASupermarketGameState::OnRep_TotalMoney()
+void ASupermarketGameState::OnRep_TotalCents()
 {
-    // This function will be called on clients when TotalMoney is updated
-    // You can add any additional logic here if needed
+    // Called on clients when TotalCents is updated, and by SettleLedger on the server
+    OnMoneyChanged.Broadcast(GetTotalMoney());
 }
 
 void ASupermarketGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(ASupermarketGameState, TotalMoney);
-}
\ No newline at end of file
+    DOREPLIFETIME(ASupermarketGameState, TotalCents);
+}
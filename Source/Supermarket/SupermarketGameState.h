@@ -3,8 +3,89 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameStateBase.h"
+#include "TransactionLog.h"
+#include "SalesAnalyticsStore.h"
 #include "SupermarketGameState.generated.h"
 
+class AProduct;
+class UProductCatalog;
+class UProductPool;
+class UStartupStockingService;
+class UProductDeliveryService;
+class UStoreMetrics;
+
+USTRUCT(BlueprintType)
+struct FSkuCount
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    FName SKU;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int32 Quantity = 0;
+
+    // Money taken for this line
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int64 Cents = 0;
+};
+
+// One sale as recorded in the ledger. Money is kept in whole cents so large totals don't drift.
+USTRUCT(BlueprintType)
+struct FSupermarketTransaction
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int32 TransactionId = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    FName CheckoutId;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int32 CustomerId = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    TArray<FSkuCount> Items;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int64 Cents = 0;
+
+    // World time at which the sale was recorded
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    float Timestamp = 0.0f;
+};
+
+// Fixed-size summary of a settled sale, what the recent sales ring keeps. The SKU lines stay in the sales store.
+USTRUCT(BlueprintType)
+struct FSupermarketTransactionSummary
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int32 TransactionId = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    FName CheckoutId;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int32 CustomerId = 0;
+
+    // Units sold over all SKU lines
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int32 NumItems = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    int64 Cents = 0;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Ledger")
+    float Timestamp = 0.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMoneyChanged, float /*NewTotalMoney*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTransactionsSettled, TArrayView<const FSupermarketTransaction> /*Settled*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSimulationSpeedChanged, float /*NewSpeed*/);
+
 UCLASS()
 class SUPERMARKET_API ASupermarketGameState : public AGameStateBase
 {
@@ -14,17 +95,155 @@ public:
     ASupermarketGameState();
 
     UFUNCTION(BlueprintCallable, Category = "Money")
-    float GetTotalMoney() const { return TotalMoney; }
+    float GetTotalMoney() const { return TotalCents / 100.0f; }
+
+    UFUNCTION(BlueprintCallable, Category = "Money")
+    int64 GetTotalCents() const { return TotalCents; }
 
+    // Adds money that isn't tied to a sale. Settled together with the frame's transactions.
     UFUNCTION(BlueprintCallable, Category = "Money")
     void AddMoney(float Amount);
 
-    UPROPERTY(ReplicatedUsing = OnRep_TotalMoney)
-    float TotalMoney;
+    // Appends a sale to the ledger. Sales are settled once at the end of the frame, so any number
+    // of checkouts finishing in the same frame cause a single replication update and broadcast.
+    void RecordTransaction(FSupermarketTransaction Transaction);
+
+    // Most recent settled sales, newest first
+    UFUNCTION(BlueprintCallable, Category = "Ledger")
+    TArray<FSupermarketTransactionSummary> GetRecentTransactions() const;
+
+    // Sales reports for the tablet, answered from the columnar sales store (server only)
+    UFUNCTION(BlueprintCallable, Category = "Sales")
+    float GetRevenueBetween(float StartTime, float EndTime) const;
+
+    // Revenue of each of the last NumHours hours, oldest first
+    UFUNCTION(BlueprintCallable, Category = "Sales")
+    TArray<float> GetRevenuePerHour(int32 NumHours) const;
+
+    // Best selling SKUs of the current day by units sold
+    UFUNCTION(BlueprintCallable, Category = "Sales")
+    TArray<FSkuCount> GetTopSellersToday(int32 Count) const;
+
+    const FSalesAnalyticsStore& GetSalesStore() const { return SalesStore; }
+
+    // SKUs carried by the store and how many units of each are on the shelves
+    UFUNCTION(BlueprintCallable, Category = "Catalog")
+    UProductCatalog* GetProductCatalog() const { return ProductCatalog; }
+
+    // Listed on the tablet from the start, other SKUs are added as soon as a shelf stocks them
+    UPROPERTY(EditDefaultsOnly, Category = "Catalog")
+    TArray<TSubclassOf<AProduct>> CatalogProductClasses;
+
+    // Product actors not currently shown anywhere, see UShoppingBag
+    UProductPool* GetProductPool() const { return ProductPool; }
+
+    // Fills the shelves that start fully stocked, OnStoreReady fires when it is done
+    UFUNCTION(BlueprintCallable, Category = "Stocking")
+    UStartupStockingService* GetStartupStocking() const { return StartupStocking; }
+
+    // Spawns ordered product boxes over several frames
+    UFUNCTION(BlueprintCallable, Category = "Delivery")
+    UProductDeliveryService* GetDeliveryService() const { return DeliveryService; }
+
+    // Fast-forwards the store by dilating world time, 1 is real time. Server only, the world settings
+    // replicate the dilation to clients.
+    UFUNCTION(BlueprintCallable, Category = "Simulation")
+    void SetSimulationSpeed(float Speed);
+
+    UFUNCTION(BlueprintCallable, Category = "Simulation")
+    float GetSimulationSpeed() const;
+
+    // True while the store runs faster than MaxCosmeticSimulationSpeed, and always on a dedicated server.
+    // Customers, checkouts and shelves then snap purely visual motion (hand and turn interpolation,
+    // conveyor travel, stocking reveals) to its end.
+    UFUNCTION(BlueprintCallable, Category = "Simulation")
+    bool ShouldSkipCosmetics() const;
+
+    // Same as above for actors that only have a world, false if there is no supermarket game state
+    static bool ShouldSkipCosmeticsIn(const UWorld* World);
+
+    UPROPERTY(EditDefaultsOnly, Category = "Simulation", meta = (ClampMin = "1"))
+    float MaxSimulationSpeed;
+
+    UPROPERTY(EditDefaultsOnly, Category = "Simulation", meta = (ClampMin = "1"))
+    float MaxCosmeticSimulationSpeed;
+
+    // Server only, fired when SetSimulationSpeed changes the speed
+    FOnSimulationSpeedChanged OnSimulationSpeedChanged;
+
+    // Customer timings and failure counts for throughput reports
+    UStoreMetrics* GetStoreMetrics() const { return StoreMetrics; }
+
+    // Server only. Every customer seeds its own random stream from here, so seeding this once makes
+    // the choices of all customers of a run repeatable.
+    void SeedCustomers(int32 Seed) { CustomerSeeds.Initialize(Seed); }
+    int32 NextCustomerSeed() { return static_cast<int32>(CustomerSeeds.GetUnsignedInt()); }
+
+    static int64 ToCents(float Amount) { return FMath::RoundToInt64(static_cast<double>(Amount) * 100.0); }
+
+    UPROPERTY(ReplicatedUsing = OnRep_TotalCents)
+    int64 TotalCents;
 
     UFUNCTION()
-    void OnRep_TotalMoney();
+    void OnRep_TotalCents();
+
+    // Fired whenever the total changes, on the server once per settled frame and on clients from replication
+    FOnMoneyChanged OnMoneyChanged;
+
+    // Server only, fired with the sales settled this frame
+    FOnTransactionsSettled OnTransactionsSettled;
+
+    // Number of settled sales kept for the tablet
+    UPROPERTY(EditDefaultsOnly, Category = "Ledger", meta = (ClampMin = "1"))
+    int32 MaxRecentTransactions;
+
+    // Persists every settled sale to Saved/Transactions on the server
+    UPROPERTY(EditDefaultsOnly, Category = "Ledger")
+    bool bWriteTransactionLog;
 
 protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
-};
\ No newline at end of file
+
+private:
+    void ScheduleSettlement();
+    void SettleLedger();
+
+    // Settles the ledger once every actor of this world has ticked
+    void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+    FDelegateHandle PostActorTickHandle;
+
+    // Recorded this frame, not yet applied to TotalCents
+    TArray<FSupermarketTransaction> PendingTransactions;
+    int64 PendingCents;
+    bool bSettlementScheduled;
+    int32 NextTransactionId;
+
+    // Ring buffer of settled sales, RecentHead is the slot the next one goes into.
+    // Summaries only, so recording a sale never allocates for the ring once it is sized.
+    TArray<FSupermarketTransactionSummary> RecentTransactions;
+    int32 RecentHead;
+    int32 NumRecent;
+
+    TUniquePtr<FTransactionLogWriter> TransactionLog;
+
+    FSalesAnalyticsStore SalesStore;
+
+    FRandomStream CustomerSeeds;
+
+    UPROPERTY()
+    UProductCatalog* ProductCatalog;
+
+    UPROPERTY()
+    UProductPool* ProductPool;
+
+    UPROPERTY()
+    UStartupStockingService* StartupStocking;
+
+    UPROPERTY()
+    UProductDeliveryService* DeliveryService;
+
+    UPROPERTY()
+    UStoreMetrics* StoreMetrics;
+};
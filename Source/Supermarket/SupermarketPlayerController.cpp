@@ -4,6 +4,7 @@
 #include "SupermarketPlayerController.h"
 #include "EnhancedInputSubsystems.h"
 #include "Engine/LocalPlayer.h"
+#include "SupermarketGameState.h"
 
 void ASupermarketPlayerController::BeginPlay()
 {
@@ -15,4 +16,19 @@ void ASupermarketPlayerController::BeginPlay()
 		// add the mapping context so we get controls
 		Subsystem->AddMappingContext(InputMappingContext, 0);
 	}
-}
\ No newline at end of file
+}
+
+void ASupermarketPlayerController::SetSimulationSpeed(float Speed)
+{
+	// The speed is the whole store's, only the host (or a standalone game) may change it
+	if (!HasAuthority())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SetSimulationSpeed ignored, only the host can change the simulation speed"));
+		return;
+	}
+
+	if (ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>())
+	{
+		GameState->SetSimulationSpeed(Speed);
+	}
+}
@@ -15,7 +15,13 @@ UCLASS()
 class SUPERMARKET_API ASupermarketPlayerController : public APlayerController
 {
 	GENERATED_BODY()
-	
+
+public:
+
+	/** Console command, fast-forwards the store (1 is real time, see ASupermarketGameState::SetSimulationSpeed). Host only. */
+	UFUNCTION(Exec, BlueprintCallable, Category = "Simulation")
+	void SetSimulationSpeed(float Speed);
+
 protected:
 
 	/** Input Mapping Context to be used for player input */
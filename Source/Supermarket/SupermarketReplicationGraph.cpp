@@ -0,0 +1,187 @@
+// SupermarketReplicationGraph.cpp
+#include "SupermarketReplicationGraph.h"
+#include "AICustomerPawn.h"
+#include "Checkout.h"
+#include "Product.h"
+#include "Shelf.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/UObjectIterator.h"
+
+USupermarketReplicationGraph::USupermarketReplicationGraph()
+{
+    GridCellSize = 2500.0f;
+    SpatialBias = FVector2D(-50000.0f, -50000.0f);
+    CustomerCullDistance = 6000.0f;
+    CustomerNetUpdateFrequency = 10.0f;
+    bDistanceBasedFrequency = true;
+    CrowdedCellListSize = 12;
+    CrowdedCellBuckets = 3;
+
+    GridNode = nullptr;
+    AlwaysRelevantNode = nullptr;
+}
+
+void USupermarketReplicationGraph::InitGlobalActorClassSettings()
+{
+    Super::InitGlobalActorClassSettings();
+
+    // Explicit policies, subclasses (Blueprints included) inherit them
+    ClassRepNodePolicies.Set(AProduct::StaticClass(), ESupermarketRepNodeMapping::NotRouted);
+    ClassRepNodePolicies.Set(AShelf::StaticClass(), ESupermarketRepNodeMapping::Spatialize_Dormancy);
+    ClassRepNodePolicies.Set(ACheckout::StaticClass(), ESupermarketRepNodeMapping::RelevantAllConnections);
+    ClassRepNodePolicies.Set(APawn::StaticClass(), ESupermarketRepNodeMapping::Spatialize_Dynamic);
+    ClassRepNodePolicies.Set(APlayerState::StaticClass(), ESupermarketRepNodeMapping::NotRouted);
+    ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), ESupermarketRepNodeMapping::NotRouted);
+    ClassRepNodePolicies.Set(AInfo::StaticClass(), ESupermarketRepNodeMapping::RelevantAllConnections);
+
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+        if (!ActorCDO || !ActorCDO->GetIsReplicated())
+        {
+            continue;
+        }
+
+        // Leftovers of Blueprint compilation
+        if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        const ESupermarketRepNodeMapping* ExplicitPolicy = ClassRepNodePolicies.Get(Class);
+        const ESupermarketRepNodeMapping Policy = ExplicitPolicy ? *ExplicitPolicy : GetDefaultMappingPolicy(ActorCDO);
+        ClassRepNodePolicies.Set(Class, Policy);
+
+        // The graph works in replication frames, convert the actor's update frequency at the server tick rate.
+        // Moving actors under bDistanceBasedFrequency take their rate from the distance instead.
+        FClassReplicationInfo ClassInfo;
+        if (Class->IsChildOf(AAICustomerPawn::StaticClass()))
+        {
+            ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CustomerNetUpdateFrequency);
+            ClassInfo.SetCullDistanceSquared(FMath::Square(CustomerCullDistance));
+        }
+        else
+        {
+            ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+            const bool bSpatialized = Policy == ESupermarketRepNodeMapping::Spatialize_Static
+                || Policy == ESupermarketRepNodeMapping::Spatialize_Dynamic
+                || Policy == ESupermarketRepNodeMapping::Spatialize_Dormancy;
+            ClassInfo.SetCullDistanceSquared(bSpatialized ? ActorCDO->NetCullDistanceSquared : 0.0f);
+        }
+        GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+    }
+}
+
+void USupermarketReplicationGraph::InitGlobalGraphNodes()
+{
+    if (bDistanceBasedFrequency)
+    {
+        // Each cell's moving actors are gathered per connection, their rate falls off with the distance to the
+        // viewer as a fraction of the class cull distance, see the node's default zones
+        UReplicationGraphNode_GridCell::CreateDynamicNodeOverride = [](UReplicationGraphNode_GridCell* Parent) -> UReplicationGraphNode*
+        {
+            return Parent->CreateChildNode<UReplicationGraphNode_DynamicSpatialFrequency>();
+        };
+    }
+    else
+    {
+        // Grid cells keep their moving actors in frequency bucket lists, these settings apply to all of them
+        UReplicationGraphNode_GridCell::CreateDynamicNodeOverride = nullptr;
+        UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.ListSize = CrowdedCellListSize;
+        UReplicationGraphNode_ActorListFrequencyBuckets::DefaultSettings.NumBuckets = CrowdedCellBuckets;
+    }
+
+    GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+    GridNode->CellSize = GridCellSize;
+    GridNode->SpatialBias = SpatialBias;
+    AddGlobalGraphNode(GridNode);
+
+    AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+    AddGlobalGraphNode(AlwaysRelevantNode);
+
+    // Replicates a limited number of player states per frame, walks the player states on its own
+    AddGlobalGraphNode(CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>());
+}
+
+void USupermarketReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+    Super::InitConnectionGraphNodes(RepGraphConnection);
+
+    // The connection's own player controller and view target, the owner-only actors that are not routed globally
+    AddConnectionGraphNode(CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>(), RepGraphConnection);
+}
+
+void USupermarketReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    switch (GetMappingPolicy(ActorInfo.Class))
+    {
+    case ESupermarketRepNodeMapping::RelevantAllConnections:
+        AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::Spatialize_Static:
+        GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::Spatialize_Dynamic:
+        GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::Spatialize_Dormancy:
+        GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::NotRouted:
+        break;
+    }
+}
+
+void USupermarketReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+    switch (GetMappingPolicy(ActorInfo.Class))
+    {
+    case ESupermarketRepNodeMapping::RelevantAllConnections:
+        AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::Spatialize_Static:
+        GridNode->RemoveActor_Static(ActorInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::Spatialize_Dynamic:
+        GridNode->RemoveActor_Dynamic(ActorInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::Spatialize_Dormancy:
+        GridNode->RemoveActor_Dormancy(ActorInfo);
+        break;
+
+    case ESupermarketRepNodeMapping::NotRouted:
+        break;
+    }
+}
+
+ESupermarketRepNodeMapping USupermarketReplicationGraph::GetMappingPolicy(const UClass* Class)
+{
+    const ESupermarketRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class);
+    return Policy ? *Policy : ESupermarketRepNodeMapping::NotRouted;
+}
+
+ESupermarketRepNodeMapping USupermarketReplicationGraph::GetDefaultMappingPolicy(const AActor* ActorCDO) const
+{
+    if (ActorCDO->bAlwaysRelevant)
+    {
+        return ESupermarketRepNodeMapping::RelevantAllConnections;
+    }
+    if (ActorCDO->bOnlyRelevantToOwner)
+    {
+        return ESupermarketRepNodeMapping::NotRouted;
+    }
+
+    // Most level actors never move, treating them as dormancy actors keeps them out of the per-frame grid updates
+    return ESupermarketRepNodeMapping::Spatialize_Dormancy;
+}
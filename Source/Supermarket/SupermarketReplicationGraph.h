@@ -0,0 +1,78 @@
+// SupermarketReplicationGraph.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "SupermarketReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+
+// Node a replicated actor class is routed to
+enum class ESupermarketRepNodeMapping : uint8
+{
+    NotRouted,              // Not gathered by the global nodes: products, owner-only actors, player states
+    RelevantAllConnections, // Always relevant node: game state, world settings, checkouts
+    Spatialize_Static,      // Grid, placed in its cells once
+    Spatialize_Dynamic,     // Grid, cells updated every frame: customers and player pawns
+    Spatialize_Dormancy,    // Grid, static while dormant and dynamic while awake: shelves
+};
+
+// Replication driver of the store, enabled through ReplicationDriverClassName in DefaultEngine.ini.
+// Relevancy is answered by a 2D grid instead of a per-actor check against every connection, so the cost
+// of a replication frame follows the number of players and what is near them, not the size of the store.
+// Moving actors in a grid cell replicate to each connection at a rate set by their distance to that
+// connection's viewer, so a customer next to one player updates every frame for them and rarely for a
+// player across the store.
+UCLASS(Transient, Config = Engine)
+class SUPERMARKET_API USupermarketReplicationGraph : public UReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+    USupermarketReplicationGraph();
+
+    virtual void InitGlobalActorClassSettings() override;
+    virtual void InitGlobalGraphNodes() override;
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+    virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+    UPROPERTY(Config)
+    float GridCellSize;
+
+    // Shifts the grid so the whole store is in positive cell coordinates
+    UPROPERTY(Config)
+    FVector2D SpatialBias;
+
+    UPROPERTY(Config)
+    float CustomerCullDistance;
+
+    UPROPERTY(Config)
+    float CustomerNetUpdateFrequency;
+
+    // Per-connection distance based rates for the grid's moving actors. When off, cells fall back to
+    // frequency buckets that are the same for every connection.
+    UPROPERTY(Config)
+    bool bDistanceBasedFrequency;
+
+    // Without bDistanceBasedFrequency, cells with more moving actors than this split them into
+    // CrowdedCellBuckets lists, one replicated per frame
+    UPROPERTY(Config)
+    int32 CrowdedCellListSize;
+
+    UPROPERTY(Config)
+    int32 CrowdedCellBuckets;
+
+private:
+    ESupermarketRepNodeMapping GetMappingPolicy(const UClass* Class);
+    ESupermarketRepNodeMapping GetDefaultMappingPolicy(const AActor* ActorCDO) const;
+
+    TClassMap<ESupermarketRepNodeMapping> ClassRepNodePolicies;
+
+    UPROPERTY()
+    UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+    UPROPERTY()
+    UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+};
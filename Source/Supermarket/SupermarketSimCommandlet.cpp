@@ -0,0 +1,409 @@
+// SupermarketSimCommandlet.cpp
+#include "SupermarketSimCommandlet.h"
+#include "SupermarketGameState.h"
+#include "StoreMetrics.h"
+#include "AICustomerPawn.h"
+#include "Shelf.h"
+#include "Checkout.h"
+#include "StoreSimulation.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "UObject/Package.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+
+USupermarketSimCommandlet::USupermarketSimCommandlet()
+{
+    IsClient = false;
+    IsEditor = false;
+    IsServer = true;
+    LogToConsole = true;
+}
+
+int32 USupermarketSimCommandlet::Main(const FString& Params)
+{
+    FSimSettings Settings;
+    if (!ParseSettings(Params, Settings))
+    {
+        return 1;
+    }
+
+    UWorld* World = StartWorld(Settings.Map);
+    if (!World)
+    {
+        return 1;
+    }
+
+    TArray<FTransform> SpawnPoints;
+    FindSpawnPoints(World, SpawnPoints);
+
+    if (Settings.bUseSim)
+    {
+        const int32 Result = RunStoreSimulation(Settings, World, SpawnPoints);
+        StopWorld(World);
+        return Result;
+    }
+
+    UClass* CustomerClass = LoadClass<AAICustomerPawn>(nullptr, *Settings.CustomerClass);
+    if (!CustomerClass)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: customer class %s not found"), *Settings.CustomerClass);
+        StopWorld(World);
+        return 1;
+    }
+
+    ASupermarketGameState* GameState = World->GetGameState<ASupermarketGameState>();
+    if (!GameState || !GameState->GetStoreMetrics())
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: %s does not use the supermarket game state"), *Settings.Map);
+        StopWorld(World);
+        return 1;
+    }
+
+    // Cosmetics are skipped above the cosmetic speed, so a faster speed costs more per frame but not per simulated second
+    GameState->SetSimulationSpeed(Settings.Speed);
+    GameState->GetStoreMetrics()->Reset();
+    GameState->SeedCustomers(Settings.Seed);
+    const int64 StartCents = GameState->GetTotalCents();
+
+    FRandomStream Random(Settings.Seed);
+    const float StartTime = World->GetTimeSeconds();
+    const float EndTime = StartTime + Settings.Hours * 3600.0f;
+    float NextArrivalTime = StartTime + NextArrivalDelay(Settings, 0.0f, Random);
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+    UE_LOG(LogTemp, Display, TEXT("SupermarketSim: running %s for %.1f hours at %.0fx"), *Settings.Map, Settings.Hours, GameState->GetSimulationSpeed());
+
+    double TickSeconds = 0.0;
+    int64 Frames = 0;
+    int32 LastReportedHour = 0;
+
+    while (World->GetTimeSeconds() < EndTime && !IsEngineExitRequested())
+    {
+        // Customers start shopping from their own BeginPlay
+        while (NextArrivalTime <= World->GetTimeSeconds())
+        {
+            const FTransform& SpawnPoint = SpawnPoints[Random.RandHelper(SpawnPoints.Num())];
+            World->SpawnActor<AAICustomerPawn>(CustomerClass, SpawnPoint, SpawnParams);
+            NextArrivalTime += NextArrivalDelay(Settings, NextArrivalTime - StartTime, Random);
+        }
+
+        const double TickStart = FPlatformTime::Seconds();
+        World->Tick(LEVELTICK_All, Settings.FrameTime);
+        TickSeconds += FPlatformTime::Seconds() - TickStart;
+
+        // Timers and other once-per-frame work key off the frame counter
+        GFrameCounter++;
+        Frames++;
+
+        const int32 Hour = FMath::FloorToInt((World->GetTimeSeconds() - StartTime) / 3600.0f);
+        if (Hour > LastReportedHour)
+        {
+            LastReportedHour = Hour;
+            UE_LOG(LogTemp, Display, TEXT("SupermarketSim: hour %d done, %d customers served, %d in store"),
+                Hour, GameState->GetStoreMetrics()->GetCustomersServed(), GameState->GetStoreMetrics()->GetCustomersInStore());
+        }
+    }
+
+    const bool bWritten = WriteReport(Settings, World, World->GetTimeSeconds() - StartTime, TickSeconds, Frames, StartCents);
+    StopWorld(World);
+    return bWritten ? 0 : 1;
+}
+
+bool USupermarketSimCommandlet::ParseSettings(const FString& Params, FSimSettings& OutSettings)
+{
+    OutSettings.Map = TEXT("/Game/FirstPerson/Maps/FirstPersonMap");
+    OutSettings.CustomerClass = TEXT("/Game/BP_AICustomer.BP_AICustomer_C");
+
+    FParse::Value(*Params, TEXT("Map="), OutSettings.Map);
+    FParse::Value(*Params, TEXT("CustomerClass="), OutSettings.CustomerClass);
+    FParse::Value(*Params, TEXT("Report="), OutSettings.ReportPath);
+    FParse::Value(*Params, TEXT("Hours="), OutSettings.Hours);
+    FParse::Value(*Params, TEXT("Speed="), OutSettings.Speed);
+    FParse::Value(*Params, TEXT("FrameTime="), OutSettings.FrameTime);
+    FParse::Value(*Params, TEXT("Seed="), OutSettings.Seed);
+    OutSettings.bUseSim = FParse::Param(*Params, TEXT("UseSim"));
+
+    FString Arrivals = TEXT("60");
+    FParse::Value(*Params, TEXT("Arrivals="), Arrivals, false);
+
+    TArray<FString> ArrivalValues;
+    Arrivals.ParseIntoArray(ArrivalValues, TEXT(","));
+    for (const FString& Value : ArrivalValues)
+    {
+        OutSettings.ArrivalsPerHour.Add(FMath::Max(FCString::Atof(*Value), 0.0f));
+    }
+
+    if (OutSettings.Hours <= 0.0f || OutSettings.FrameTime <= 0.0f || OutSettings.ArrivalsPerHour.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: Hours, FrameTime and Arrivals need positive values"));
+        return false;
+    }
+
+    if (OutSettings.ReportPath.IsEmpty())
+    {
+        OutSettings.ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SimReports"),
+            FString::Printf(TEXT("%s_%s.json"), *FPaths::GetBaseFilename(OutSettings.Map), *FDateTime::Now().ToString()));
+    }
+    return true;
+}
+
+UWorld* USupermarketSimCommandlet::StartWorld(const FString& MapName)
+{
+    UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+    UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: could not load map %s"), *MapName);
+        return nullptr;
+    }
+
+    World->AddToRoot();
+    World->WorldType = EWorldType::Game;
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    World->InitWorld(UWorld::InitializationValues()
+        .AllowAudioPlayback(false)
+        .RequiresHitProxies(false)
+        .CreatePhysicsScene(true)
+        .CreateNavigation(true)
+        .CreateAISystem(true)
+        .ShouldSimulatePhysics(true)
+        .SetTransactional(false));
+    World->UpdateWorldComponents(true, true);
+
+    FURL URL(*MapName);
+    if (!World->SetGameMode(URL))
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: could not create the game mode for %s"), *MapName);
+        StopWorld(World);
+        return nullptr;
+    }
+
+    World->InitializeActorsForPlay(URL);
+    World->BeginPlay();
+    return World;
+}
+
+void USupermarketSimCommandlet::StopWorld(UWorld* World)
+{
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+}
+
+void USupermarketSimCommandlet::FindSpawnPoints(UWorld* World, TArray<FTransform>& OutSpawnPoints)
+{
+    static const FName CustomerSpawnTag(TEXT("CustomerSpawn"));
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        if (It->ActorHasTag(CustomerSpawnTag))
+        {
+            OutSpawnPoints.Add(It->GetActorTransform());
+        }
+    }
+
+    if (OutSpawnPoints.Num() == 0)
+    {
+        for (TActorIterator<APlayerStart> It(World); It; ++It)
+        {
+            OutSpawnPoints.Add(It->GetActorTransform());
+        }
+    }
+
+    if (OutSpawnPoints.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("SupermarketSim: no CustomerSpawn actors or player starts, customers spawn at the origin"));
+        OutSpawnPoints.Add(FTransform::Identity);
+    }
+}
+
+float USupermarketSimCommandlet::NextArrivalDelay(const FSimSettings& Settings, float SimTime, FRandomStream& Random)
+{
+    const int32 Hour = FMath::Clamp(FMath::FloorToInt(SimTime / 3600.0f), 0, Settings.ArrivalsPerHour.Num() - 1);
+    const float PerHour = Settings.ArrivalsPerHour[Hour];
+    if (PerHour <= 0.0f)
+    {
+        // Closed hour, look again at the start of the next one
+        return FMath::Max((Hour + 1) * 3600.0f - SimTime, 1.0f);
+    }
+
+    return -FMath::Loge(1.0f - Random.FRand() * 0.999f) * 3600.0f / PerHour;
+}
+
+bool USupermarketSimCommandlet::WriteReport(const FSimSettings& Settings, UWorld* World, double SimulatedSeconds, double TickSeconds, int64 Frames, int64 StartCents)
+{
+    const ASupermarketGameState* GameState = World->GetGameState<ASupermarketGameState>();
+    const UStoreMetrics* Metrics = GameState->GetStoreMetrics();
+
+    const int64 RevenueCents = GameState->GetTotalCents() - StartCents;
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("map"), Settings.Map);
+    Report->SetNumberField(TEXT("seed"), Settings.Seed);
+    Report->SetNumberField(TEXT("simulation_speed"), GameState->GetSimulationSpeed());
+    Report->SetNumberField(TEXT("simulated_seconds"), SimulatedSeconds);
+    Report->SetNumberField(TEXT("frames"), static_cast<double>(Frames));
+
+    Report->SetNumberField(TEXT("customers_entered"), Metrics->GetCustomersEntered());
+    Report->SetNumberField(TEXT("customers_served"), Metrics->GetCustomersServed());
+    Report->SetNumberField(TEXT("customers_left_unserved"), Metrics->GetCustomersLeftUnserved());
+    Report->SetNumberField(TEXT("customers_in_store_at_end"), Metrics->GetCustomersInStore());
+    Report->SetObjectField(TEXT("time_in_store_seconds"), MakeDistribution(Metrics->GetTimesInStore()));
+    Report->SetObjectField(TEXT("queue_wait_seconds"), MakeDistribution(Metrics->GetQueueWaits()));
+    Report->SetNumberField(TEXT("failed_picks"), Metrics->GetFailedPicks());
+    Report->SetNumberField(TEXT("navigation_failures"), Metrics->GetNavigationFailures());
+    Report->SetNumberField(TEXT("revenue_cents"), static_cast<double>(RevenueCents));
+
+    // World tick time only, loading and spawning are left out
+    Report->SetNumberField(TEXT("game_thread_seconds"), TickSeconds);
+    Report->SetNumberField(TEXT("game_thread_ms_per_simulated_second"), SimulatedSeconds > 0.0 ? TickSeconds * 1000.0 / SimulatedSeconds : 0.0);
+
+    if (!SaveReport(Settings, Report))
+    {
+        return false;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("SupermarketSim: %d customers served, revenue %.2f, %.2f ms per simulated second. Report written to %s"),
+        Metrics->GetCustomersServed(), RevenueCents / 100.0, SimulatedSeconds > 0.0 ? TickSeconds * 1000.0 / SimulatedSeconds : 0.0, *Settings.ReportPath);
+    return true;
+}
+
+int32 USupermarketSimCommandlet::RunStoreSimulation(const FSimSettings& Settings, UWorld* World, const TArray<FTransform>& SpawnPoints)
+{
+    FStoreSimConfig Config;
+    Config.Seed = static_cast<uint32>(Settings.Seed);
+    FStoreSimulation Simulation(Config);
+
+    // One simulated product per SKU, shelves start with what the level stocked them with
+    TMap<FName, int32> ProductIndices;
+    for (TActorIterator<AShelf> It(World); It; ++It)
+    {
+        const TSubclassOf<AProduct> ProductClass = It->GetCurrentProductClass();
+        if (!ProductClass)
+        {
+            continue;
+        }
+
+        const AProduct* DefaultProduct = ProductClass->GetDefaultObject<AProduct>();
+        int32* ProductIndex = ProductIndices.Find(DefaultProduct->GetSKU());
+        if (!ProductIndex)
+        {
+            ProductIndex = &ProductIndices.Add(DefaultProduct->GetSKU(),
+                Simulation.AddProduct(DefaultProduct->GetSKU(), ASupermarketGameState::ToCents(DefaultProduct->GetPrice())));
+        }
+
+        const int32 InitialStock = It->bStartFullyStocked ? It->MaxProducts : It->GetProductCount();
+        Simulation.AddShelf(It->GetActorLocation(), *ProductIndex, It->MaxProducts, InitialStock);
+    }
+
+    for (TActorIterator<ACheckout> It(World); It; ++It)
+    {
+        Simulation.AddCheckout(It->GetActorLocation());
+    }
+
+    if (Simulation.GetShelves().Num() == 0 || Simulation.GetCheckouts().Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: %s has no stocked shelves or no checkouts to simulate"), *Settings.Map);
+        return 1;
+    }
+
+    // The simulation has a single entrance
+    Simulation.SetEntrance(SpawnPoints[0].GetLocation());
+
+    int64 RevenueCents = 0;
+    Simulation.OnSale = [&RevenueCents](const FSimSale& Sale)
+    {
+        RevenueCents += Sale.Cents;
+    };
+
+    // Same arrival schedule and stream as the actor run
+    Simulation.SetAutomaticArrivals(false);
+    FRandomStream Random(Settings.Seed);
+    const double Duration = Settings.Hours * 3600.0;
+    double NextArrival = NextArrivalDelay(Settings, 0.0f, Random);
+
+    const double StartTime = FPlatformTime::Seconds();
+    while (Simulation.GetTime() < Duration)
+    {
+        while (NextArrival <= Simulation.GetTime() && NextArrival < Duration)
+        {
+            Simulation.SpawnCustomer();
+            NextArrival += NextArrivalDelay(Settings, static_cast<float>(NextArrival), Random);
+        }
+        Simulation.RunFor(Config.FixedTimestep);
+    }
+    const double RunSeconds = FPlatformTime::Seconds() - StartTime;
+
+    const FStoreSimStats& Stats = Simulation.GetStats();
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("map"), Settings.Map);
+    Report->SetStringField(TEXT("mode"), TEXT("sim"));
+    Report->SetNumberField(TEXT("seed"), Settings.Seed);
+    Report->SetNumberField(TEXT("simulated_seconds"), Simulation.GetTime());
+
+    Report->SetNumberField(TEXT("customers_entered"), Stats.CustomersArrived);
+    Report->SetNumberField(TEXT("customers_served"), Stats.CustomersServed);
+    Report->SetNumberField(TEXT("customers_left_unserved"), Stats.CustomersLeftEmptyHanded);
+    Report->SetNumberField(TEXT("customers_in_store_at_end"), Simulation.GetNumCustomersInStore());
+    Report->SetObjectField(TEXT("time_in_store_seconds"), MakeDistribution(Stats.TimesInStore));
+    Report->SetObjectField(TEXT("queue_wait_seconds"), MakeDistribution(Stats.QueueWaits));
+    Report->SetNumberField(TEXT("failed_picks"), Stats.FailedPicks);
+    Report->SetNumberField(TEXT("items_sold"), Stats.ItemsSold);
+    Report->SetNumberField(TEXT("max_queue_length"), Stats.MaxQueueLength);
+    Report->SetNumberField(TEXT("revenue_cents"), static_cast<double>(RevenueCents));
+    Report->SetNumberField(TEXT("run_seconds"), RunSeconds);
+
+    if (!SaveReport(Settings, Report))
+    {
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("SupermarketSim: simulated %d shelves and %d checkouts, %d customers served, revenue %.2f in %.3f s. Report written to %s"),
+        Simulation.GetShelves().Num(), Simulation.GetCheckouts().Num(), Stats.CustomersServed, RevenueCents / 100.0, RunSeconds, *Settings.ReportPath);
+    return 0;
+}
+
+TSharedRef<FJsonObject> USupermarketSimCommandlet::MakeDistribution(const TArray<float>& Values)
+{
+    float Sum = 0.0f;
+    float Max = 0.0f;
+    for (float Value : Values)
+    {
+        Sum += Value;
+        Max = FMath::Max(Max, Value);
+    }
+
+    TSharedRef<FJsonObject> Distribution = MakeShared<FJsonObject>();
+    Distribution->SetNumberField(TEXT("count"), Values.Num());
+    Distribution->SetNumberField(TEXT("average"), Values.Num() > 0 ? Sum / Values.Num() : 0.0f);
+    Distribution->SetNumberField(TEXT("p50"), UStoreMetrics::Percentile(Values, 50.0f));
+    Distribution->SetNumberField(TEXT("p90"), UStoreMetrics::Percentile(Values, 90.0f));
+    Distribution->SetNumberField(TEXT("p95"), UStoreMetrics::Percentile(Values, 95.0f));
+    Distribution->SetNumberField(TEXT("p99"), UStoreMetrics::Percentile(Values, 99.0f));
+    Distribution->SetNumberField(TEXT("max"), Max);
+    return Distribution;
+}
+
+bool USupermarketSimCommandlet::SaveReport(const FSimSettings& Settings, const TSharedRef<FJsonObject>& Report)
+{
+    FString Output;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+    if (!FJsonSerializer::Serialize(Report, Writer) || !FFileHelper::SaveStringToFile(Output, *Settings.ReportPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("SupermarketSim: could not write report to %s"), *Settings.ReportPath);
+        return false;
+    }
+    return true;
+}
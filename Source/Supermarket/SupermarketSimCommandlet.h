@@ -0,0 +1,65 @@
+// SupermarketSimCommandlet.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SupermarketSimCommandlet.generated.h"
+
+class AAICustomerPawn;
+class FJsonObject;
+
+// Plays a store level headless and writes a throughput report. Customers arrive from a per-hour schedule
+// and the world is ticked back to back at the given simulation speed until the requested hours have passed.
+//
+// UnrealEditor-Cmd Supermarket.uproject -run=SupermarketSim -nullrhi -unattended
+//     -Map=/Game/FirstPerson/Maps/FirstPersonMap -Hours=8 -Arrivals=20,40,60,40 -Speed=20 -Seed=1
+//     -CustomerClass=/Game/BP_AICustomer.BP_AICustomer_C -Report=<path>.json [-UseSim]
+//
+// Arrivals are customers per hour for each simulated hour, the last value repeats. Customers spawn at actors
+// tagged CustomerSpawn, or at the player starts if there are none. The report goes to Saved/SimReports
+// unless -Report is given.
+//
+// With -UseSim the level is only read for its layout. Shelves, checkouts and the spawn point go into an
+// FStoreSimulation that runs the same schedule without actors, which takes seconds for a whole day.
+UCLASS()
+class SUPERMARKET_API USupermarketSimCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USupermarketSimCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    struct FSimSettings
+    {
+        FString Map;
+        FString CustomerClass;
+        FString ReportPath;
+        float Hours = 8.0f;
+        TArray<float> ArrivalsPerHour;
+        float Speed = 20.0f;
+        float FrameTime = 1.0f / 30.0f;
+        int32 Seed = 1;
+        bool bUseSim = false;
+    };
+
+    static bool ParseSettings(const FString& Params, FSimSettings& OutSettings);
+
+    static UWorld* StartWorld(const FString& MapName);
+    static void StopWorld(UWorld* World);
+
+    static void FindSpawnPoints(UWorld* World, TArray<FTransform>& OutSpawnPoints);
+
+    // Seconds until the next arrival at the schedule's rate for the given simulated time, exponentially distributed
+    static float NextArrivalDelay(const FSimSettings& Settings, float SimTime, FRandomStream& Random);
+
+    static bool WriteReport(const FSimSettings& Settings, UWorld* World, double SimulatedSeconds, double TickSeconds, int64 Frames, int64 StartCents);
+
+    // The -UseSim path: builds the store simulation from the level and writes its report
+    static int32 RunStoreSimulation(const FSimSettings& Settings, UWorld* World, const TArray<FTransform>& SpawnPoints);
+
+    static TSharedRef<FJsonObject> MakeDistribution(const TArray<float>& Values);
+    static bool SaveReport(const FSimSettings& Settings, const TSharedRef<FJsonObject>& Report);
+};
@@ -0,0 +1,63 @@
+// TabletCatalogEntryWidget.cpp
+#include "TabletCatalogEntryWidget.h"
+#include "ProductCatalog.h"
+#include "Components/TextBlock.h"
+#include "TabletWidgetComponent.h"
+
+void UTabletCatalogEntryWidget::NativeOnListItemObjectSet(UObject* ListItemObject)
+{
+    IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+    UnbindItem();
+
+    UProductCatalogItem* Item = Cast<UProductCatalogItem>(ListItemObject);
+    if (!Item)
+    {
+        return;
+    }
+
+    BoundItem = Item;
+    ItemChangedHandle = Item->OnChanged.AddUObject(this, &UTabletCatalogEntryWidget::RefreshRow);
+
+    if (NameText)
+    {
+        NameText->SetText(FText::FromString(Item->GetDisplayName()));
+    }
+    RefreshRow(Item);
+}
+
+void UTabletCatalogEntryWidget::NativeOnEntryReleased()
+{
+    IUserObjectListEntry::NativeOnEntryReleased();
+    UnbindItem();
+}
+
+void UTabletCatalogEntryWidget::NativeDestruct()
+{
+    UnbindItem();
+    Super::NativeDestruct();
+}
+
+void UTabletCatalogEntryWidget::UnbindItem()
+{
+    if (UProductCatalogItem* Item = BoundItem.Get())
+    {
+        Item->OnChanged.Remove(ItemChangedHandle);
+    }
+    BoundItem.Reset();
+    ItemChangedHandle.Reset();
+}
+
+void UTabletCatalogEntryWidget::RefreshRow(UProductCatalogItem* Item)
+{
+    if (PriceText)
+    {
+        PriceText->SetText(FText::FromString(FString::Printf(TEXT("$%.2f"), Item->GetPrice())));
+    }
+    if (StockText)
+    {
+        StockText->SetText(FText::AsNumber(Item->GetStock()));
+    }
+
+    UTabletWidgetComponent::RequestRedrawForWidget(this);
+}
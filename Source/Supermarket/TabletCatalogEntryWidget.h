@@ -0,0 +1,38 @@
+// TabletCatalogEntryWidget.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "TabletCatalogEntryWidget.generated.h"
+
+class UProductCatalogItem;
+
+// Row of the tablet catalog. The list view recycles a handful of these for whatever rows are on screen,
+// each one listens to its current item and redraws only when that item's price or stock changes.
+UCLASS()
+class SUPERMARKET_API UTabletCatalogEntryWidget : public UUserWidget, public IUserObjectListEntry
+{
+    GENERATED_BODY()
+
+protected:
+    virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+    virtual void NativeOnEntryReleased() override;
+    virtual void NativeDestruct() override;
+
+    UPROPERTY(meta = (BindWidget))
+    class UTextBlock* NameText;
+
+    UPROPERTY(meta = (BindWidget))
+    class UTextBlock* PriceText;
+
+    UPROPERTY(meta = (BindWidget))
+    class UTextBlock* StockText;
+
+private:
+    void UnbindItem();
+    void RefreshRow(UProductCatalogItem* Item);
+
+    TWeakObjectPtr<UProductCatalogItem> BoundItem;
+    FDelegateHandle ItemChangedHandle;
+};
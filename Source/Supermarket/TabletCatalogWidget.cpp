@@ -0,0 +1,76 @@
+// TabletCatalogWidget.cpp
+#include "TabletCatalogWidget.h"
+#include "ProductCatalog.h"
+#include "SupermarketGameState.h"
+#include "Components/ListView.h"
+#include "Components/EditableTextBox.h"
+#include "TabletWidgetComponent.h"
+
+void UTabletCatalogWidget::NativeConstruct()
+{
+    Super::NativeConstruct();
+
+    if (SearchBox)
+    {
+        SearchBox->OnTextChanged.AddUniqueDynamic(this, &UTabletCatalogWidget::HandleSearchTextChanged);
+    }
+
+    if (ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>())
+    {
+        Catalog = GameState->GetProductCatalog();
+    }
+
+    if (UProductCatalog* CurrentCatalog = Catalog.Get())
+    {
+        ItemsAddedHandle = CurrentCatalog->OnItemsAdded.AddUObject(this, &UTabletCatalogWidget::HandleCatalogItemsAdded);
+    }
+
+    RefreshListItems();
+}
+
+void UTabletCatalogWidget::NativeDestruct()
+{
+    if (UProductCatalog* CurrentCatalog = Catalog.Get())
+    {
+        CurrentCatalog->OnItemsAdded.Remove(ItemsAddedHandle);
+    }
+    ItemsAddedHandle.Reset();
+    Catalog.Reset();
+
+    Super::NativeDestruct();
+}
+
+void UTabletCatalogWidget::SetSearchPrefix(const FString& Prefix)
+{
+    if (SearchPrefix != Prefix)
+    {
+        SearchPrefix = Prefix;
+        RefreshListItems();
+    }
+}
+
+void UTabletCatalogWidget::HandleSearchTextChanged(const FText& Text)
+{
+    SetSearchPrefix(Text.ToString());
+}
+
+void UTabletCatalogWidget::HandleCatalogItemsAdded()
+{
+    RefreshListItems();
+}
+
+void UTabletCatalogWidget::RefreshListItems()
+{
+    UProductCatalog* CurrentCatalog = Catalog.Get();
+    if (!ProductList || !CurrentCatalog)
+    {
+        return;
+    }
+
+    // Only the item array is replaced, the list view keeps its entry widgets and refills the visible ones
+    TArray<UProductCatalogItem*> MatchingItems;
+    CurrentCatalog->FindByPrefix(SearchPrefix, MatchingItems);
+    ProductList->SetListItems(MatchingItems);
+
+    UTabletWidgetComponent::RequestRedrawForWidget(this);
+}
@@ -0,0 +1,43 @@
+// TabletCatalogWidget.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "TabletCatalogWidget.generated.h"
+
+class UProductCatalog;
+
+// Product list shown on the tablet. Rows are UProductCatalogItem objects in a UListView, which only creates
+// entry widgets for the rows in view, so opening the tablet costs the same for ten SKUs as for ten thousand.
+// Typing in the search box filters by name prefix through the catalog's search index.
+UCLASS()
+class SUPERMARKET_API UTabletCatalogWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    UFUNCTION(BlueprintCallable, Category = "Tablet")
+    void SetSearchPrefix(const FString& Prefix);
+
+protected:
+    virtual void NativeConstruct() override;
+    virtual void NativeDestruct() override;
+
+    // Its entry widget class must be a UTabletCatalogEntryWidget
+    UPROPERTY(meta = (BindWidget))
+    class UListView* ProductList;
+
+    UPROPERTY(meta = (BindWidgetOptional))
+    class UEditableTextBox* SearchBox;
+
+private:
+    UFUNCTION()
+    void HandleSearchTextChanged(const FText& Text);
+
+    void HandleCatalogItemsAdded();
+    void RefreshListItems();
+
+    TWeakObjectPtr<UProductCatalog> Catalog;
+    FDelegateHandle ItemsAddedHandle;
+    FString SearchPrefix;
+};
@@ -0,0 +1,141 @@
+// TabletWidgetComponent.cpp
+#include "TabletWidgetComponent.h"
+#include "SupermarketGameState.h"
+#include "Blueprint/UserWidget.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+UTabletWidgetComponent::UTabletWidgetComponent()
+{
+    MinRedrawInterval = 1.0f / 30.0f;
+    IdleRedrawInterval = 0.0f;
+
+    bRedrawPending = true;
+    bIsStowed = false;
+    LastRedrawTime = 0.0;
+    LastCursorPosition = FVector2D::ZeroVector;
+
+    // Drawing is decided by ShouldDrawWidget below, the engine's own manual mode only covers explicit requests
+    bManuallyRedraw = false;
+}
+
+void UTabletWidgetComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // Nothing is ever drawn on a dedicated server
+    if (GetNetMode() == NM_DedicatedServer)
+    {
+        SetComponentTickEnabled(false);
+        return;
+    }
+
+    // Money shown on the tablet changes at most once per frame through the ledger
+    if (ASupermarketGameState* GameState = GetWorld()->GetGameState<ASupermarketGameState>())
+    {
+        MoneyChangedHandle = GameState->OnMoneyChanged.AddUObject(this, &UTabletWidgetComponent::HandleMoneyChanged);
+    }
+}
+
+void UTabletWidgetComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    const UWorld* World = GetWorld();
+    if (ASupermarketGameState* GameState = World ? World->GetGameState<ASupermarketGameState>() : nullptr)
+    {
+        GameState->OnMoneyChanged.Remove(MoneyChangedHandle);
+    }
+    MoneyChangedHandle.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UTabletWidgetComponent::RequestRedraw()
+{
+    bRedrawPending = true;
+}
+
+void UTabletWidgetComponent::RequestRedrawForWidget(const UUserWidget* Widget)
+{
+    APawn* OwningPawn = Widget ? Widget->GetOwningPlayerPawn() : nullptr;
+    if (UTabletWidgetComponent* Tablet = OwningPawn ? OwningPawn->FindComponentByClass<UTabletWidgetComponent>() : nullptr)
+    {
+        Tablet->RequestRedraw();
+    }
+}
+
+void UTabletWidgetComponent::SetStowed(bool bStowed)
+{
+    bIsStowed = bStowed;
+    SetVisibility(!bStowed);
+
+    if (bStowed)
+    {
+        // Let the texture go, it is recreated on the first draw after the tablet comes out again
+        RenderTarget = nullptr;
+        UpdateMaterialInstanceParameters();
+    }
+    else
+    {
+        RequestRedraw();
+    }
+}
+
+void UTabletWidgetComponent::UpdateWidget()
+{
+    Super::UpdateWidget();
+
+    // A new widget class or draw size needs a first draw
+    RequestRedraw();
+}
+
+void UTabletWidgetComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    // Hover highlights change when the cursor moves over the screen, nothing else reports them
+    const APawn* OwningPawn = Cast<APawn>(GetOwner());
+    const APlayerController* PC = OwningPawn ? OwningPawn->GetController<APlayerController>() : nullptr;
+    FVector2D CursorPosition;
+    if (!bIsStowed && PC && PC->ShouldShowMouseCursor() && PC->GetMousePosition(CursorPosition.X, CursorPosition.Y))
+    {
+        if (!CursorPosition.Equals(LastCursorPosition))
+        {
+            RequestRedraw();
+        }
+        LastCursorPosition = CursorPosition;
+    }
+
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+bool UTabletWidgetComponent::ShouldDrawWidget() const
+{
+    if (bIsStowed || !Super::ShouldDrawWidget())
+    {
+        return false;
+    }
+
+    const double Now = GetWorld()->GetRealTimeSeconds();
+    const double SinceLastRedraw = Now - LastRedrawTime;
+
+    // A playing widget animation changes the screen every frame, it is drawn at the capped rate until it ends
+    const UUserWidget* Widget = GetUserWidgetObject();
+    const bool bAnimating = Widget && Widget->IsAnyAnimationPlaying();
+
+    if ((bRedrawPending || bAnimating) && SinceLastRedraw >= MinRedrawInterval)
+    {
+        return true;
+    }
+    return IdleRedrawInterval > 0.0f && SinceLastRedraw >= IdleRedrawInterval;
+}
+
+void UTabletWidgetComponent::DrawWidgetToRenderTarget(float DeltaTime)
+{
+    Super::DrawWidgetToRenderTarget(DeltaTime);
+
+    bRedrawPending = false;
+    LastRedrawTime = GetWorld()->GetRealTimeSeconds();
+}
+
+void UTabletWidgetComponent::HandleMoneyChanged(float NewTotalMoney)
+{
+    RequestRedraw();
+}
@@ -0,0 +1,59 @@
+// TabletWidgetComponent.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/WidgetComponent.h"
+#include "TabletWidgetComponent.generated.h"
+
+class UUserWidget;
+
+// Widget component for the tablet screen that only renders its widget when something asked for it:
+// a click on the tablet, the cursor moving over it, a widget animation, a change in data the screen shows,
+// or the widget itself calling RequestRedraw.
+// Requests are coalesced and drawn at most once per MinRedrawInterval. While the tablet is stowed
+// the render target is released.
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class SUPERMARKET_API UTabletWidgetComponent : public UWidgetComponent
+{
+    GENERATED_BODY()
+
+public:
+    UTabletWidgetComponent();
+
+    virtual void UpdateWidget() override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    UFUNCTION(BlueprintCallable, Category = "Tablet")
+    void RequestRedraw();
+
+    // Redraws the tablet of whichever player owns the widget, for widgets that change their own content
+    static void RequestRedrawForWidget(const UUserWidget* Widget);
+
+    // Hides the screen and drops its render target, or shows it again with a fresh draw
+    UFUNCTION(BlueprintCallable, Category = "Tablet")
+    void SetStowed(bool bStowed);
+
+    // Fastest the screen is ever redrawn
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tablet", meta = (ClampMin = "0.0"))
+    float MinRedrawInterval;
+
+    // Periodic fallback redraw for widgets that change without telling the tablet, 0 (the default) disables it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tablet", meta = (ClampMin = "0.0"))
+    float IdleRedrawInterval;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual bool ShouldDrawWidget() const override;
+    virtual void DrawWidgetToRenderTarget(float DeltaTime) override;
+
+private:
+    void HandleMoneyChanged(float NewTotalMoney);
+
+    bool bRedrawPending;
+    bool bIsStowed;
+    double LastRedrawTime;
+    // Cursor position at the last tick, hover states follow the cursor
+    FVector2D LastCursorPosition;
+    FDelegateHandle MoneyChangedHandle;
+};
@@ -0,0 +1,363 @@
+// TransactionLog.cpp
+#include "TransactionLog.h"
+#include "SupermarketGameState.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Misc/FileHelper.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+    void CopyName(ANSICHAR* Dest, int32 DestSize, FName Name)
+    {
+        const FString NameString = Name.IsNone() ? FString() : Name.ToString();
+        FCStringAnsi::Strncpy(Dest, TCHAR_TO_ANSI(*NameString), DestSize);
+    }
+
+    FString EscapeCSV(const ANSICHAR* Value)
+    {
+        FString Result = ANSI_TO_TCHAR(Value);
+        if (Result.Contains(TEXT(",")) || Result.Contains(TEXT("\"")))
+        {
+            Result = FString::Printf(TEXT("\"%s\""), *Result.Replace(TEXT("\""), TEXT("\"\"")));
+        }
+        return Result;
+    }
+
+    FString EscapeJSON(const ANSICHAR* Value)
+    {
+        return FString(ANSI_TO_TCHAR(Value)).Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+    }
+}
+
+FTransactionLogQueue::FTransactionLogQueue(uint32 InCapacity)
+{
+    const uint32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 2u));
+    Mask = Capacity - 1;
+
+    Slots = MakeUnique<FSlot[]>(Capacity);
+    for (uint32 i = 0; i < Capacity; ++i)
+    {
+        Slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    EnqueuePos.store(0, std::memory_order_relaxed);
+    DequeuePos.store(0, std::memory_order_relaxed);
+}
+
+bool FTransactionLogQueue::Push(const FTransactionLogRecord& Record)
+{
+    uint64 Pos = EnqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        FSlot& Slot = Slots[Pos & Mask];
+        const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+        const int64 Diff = static_cast<int64>(Sequence) - static_cast<int64>(Pos);
+
+        if (Diff == 0)
+        {
+            // The slot is free for this position, claim it
+            if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+            {
+                Slot.Record = Record;
+                Slot.Sequence.store(Pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (Diff < 0)
+        {
+            // The consumer hasn't freed this slot yet, the queue is full
+            return false;
+        }
+        else
+        {
+            Pos = EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+uint32 FTransactionLogQueue::GetApproximateSize() const
+{
+    const uint64 Enqueued = EnqueuePos.load(std::memory_order_relaxed);
+    const uint64 Dequeued = DequeuePos.load(std::memory_order_relaxed);
+    return Enqueued > Dequeued ? static_cast<uint32>(Enqueued - Dequeued) : 0;
+}
+
+bool FTransactionLogQueue::Pop(FTransactionLogRecord& OutRecord)
+{
+    const uint64 Pos = DequeuePos.load(std::memory_order_relaxed);
+    FSlot& Slot = Slots[Pos & Mask];
+    const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+
+    if (static_cast<int64>(Sequence) - static_cast<int64>(Pos + 1) < 0)
+    {
+        return false;
+    }
+
+    OutRecord = Slot.Record;
+    DequeuePos.store(Pos + 1, std::memory_order_relaxed);
+    Slot.Sequence.store(Pos + Mask + 1, std::memory_order_release);
+    return true;
+}
+
+FTransactionLogWriter::FTransactionLogWriter(const FString& InDirectory, int64 InMaxFileSize, uint32 QueueCapacity)
+    : Directory(InDirectory)
+    , MaxFileSize(InMaxFileSize)
+    , Queue(QueueCapacity)
+    , NumDroppedRecords(0)
+    , bStopping(false)
+    , WakeEvent(FPlatformProcess::GetSynchEventFromPool(false))
+    , Thread(nullptr)
+    , FileHandle(nullptr)
+    , FileSize(0)
+    , FileIndex(0)
+{
+    Thread = FRunnableThread::Create(this, TEXT("TransactionLogWriter"), 0, TPri_BelowNormal);
+}
+
+FTransactionLogWriter::~FTransactionLogWriter()
+{
+    if (Thread)
+    {
+        // Run drains the queue before it returns
+        Stop();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+}
+
+void FTransactionLogWriter::Append(const FSupermarketTransaction& Transaction)
+{
+    FTransactionLogRecord Record;
+    Record.TransactionCents = Transaction.Cents;
+    Record.Timestamp = Transaction.Timestamp;
+    Record.TransactionId = Transaction.TransactionId;
+    Record.CustomerId = Transaction.CustomerId;
+    CopyName(Record.CheckoutId, UE_ARRAY_COUNT(Record.CheckoutId), Transaction.CheckoutId);
+
+    int32 NumPushed = 0;
+    const int32 NumRecords = FMath::Max(1, Transaction.Items.Num());
+    for (int32 i = 0; i < NumRecords; ++i)
+    {
+        if (Transaction.Items.IsValidIndex(i))
+        {
+            Record.Quantity = Transaction.Items[i].Quantity;
+            Record.LineCents = Transaction.Items[i].Cents;
+            CopyName(Record.SKU, UE_ARRAY_COUNT(Record.SKU), Transaction.Items[i].SKU);
+        }
+
+        if (Queue.Push(Record))
+        {
+            ++NumPushed;
+        }
+    }
+
+    if (NumPushed < NumRecords)
+    {
+        NumDroppedRecords.fetch_add(NumRecords - NumPushed, std::memory_order_relaxed);
+    }
+
+    // The writer batches on its own schedule, only wake it early once the queue is filling up
+    if (Queue.GetApproximateSize() >= Queue.GetCapacity() / 4)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+uint32 FTransactionLogWriter::Run()
+{
+    TArray<uint8> Batch;
+    Batch.Reserve(64 * 1024);
+
+    for (;;)
+    {
+        const bool bStopRequested = bStopping.load(std::memory_order_acquire);
+
+        FTransactionLogRecord Record;
+        while (Queue.Pop(Record))
+        {
+            // Every record is prefixed with its size so readers can skip records of a newer layout
+            const uint32 RecordSize = sizeof(FTransactionLogRecord);
+            Batch.Append(reinterpret_cast<const uint8*>(&RecordSize), sizeof(RecordSize));
+            Batch.Append(reinterpret_cast<const uint8*>(&Record), RecordSize);
+
+            if (Batch.Num() >= 64 * 1024)
+            {
+                WriteBatch(Batch);
+            }
+        }
+
+        WriteBatch(Batch);
+
+        if (bStopRequested)
+        {
+            break;
+        }
+
+        WakeEvent->Wait(FTimespan::FromMilliseconds(250));
+    }
+
+    if (FileHandle)
+    {
+        delete FileHandle;
+        FileHandle = nullptr;
+    }
+    return 0;
+}
+
+void FTransactionLogWriter::Stop()
+{
+    bStopping.store(true, std::memory_order_release);
+    WakeEvent->Trigger();
+}
+
+void FTransactionLogWriter::WriteBatch(TArray<uint8>& Batch)
+{
+    if (Batch.Num() == 0)
+    {
+        return;
+    }
+
+    if ((!FileHandle || FileSize + Batch.Num() > MaxFileSize) && !OpenNewFile())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Transaction log could not open a file in %s, %d bytes lost"), *Directory, Batch.Num());
+        Batch.Reset();
+        return;
+    }
+
+    FileHandle->Write(Batch.GetData(), Batch.Num());
+    FileHandle->Flush();
+    FileSize += Batch.Num();
+    Batch.Reset();
+}
+
+bool FTransactionLogWriter::OpenNewFile()
+{
+    if (FileHandle)
+    {
+        delete FileHandle;
+        FileHandle = nullptr;
+    }
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*Directory);
+
+    // Timestamp first so files sort in the order they were written
+    const FString FileName = FString::Printf(TEXT("Transactions_%s_%03d.bin"), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")), FileIndex++);
+    FileHandle = PlatformFile.OpenWrite(*FPaths::Combine(Directory, FileName));
+    if (!FileHandle)
+    {
+        return false;
+    }
+
+    FileHandle->Write(reinterpret_cast<const uint8*>(&FileMagic), sizeof(FileMagic));
+    FileHandle->Write(reinterpret_cast<const uint8*>(&FileVersion), sizeof(FileVersion));
+    FileSize = sizeof(FileMagic) + sizeof(FileVersion);
+    return true;
+}
+
+bool FTransactionLogReader::ReadFile(const FString& FilePath, TArray<FTransactionLogRecord>& OutRecords)
+{
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+    {
+        return false;
+    }
+
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    if (Data.Num() < static_cast<int32>(sizeof(Magic) + sizeof(Version)))
+    {
+        return false;
+    }
+    FMemory::Memcpy(&Magic, Data.GetData(), sizeof(Magic));
+    FMemory::Memcpy(&Version, Data.GetData() + sizeof(Magic), sizeof(Version));
+    if (Magic != FTransactionLogWriter::FileMagic || Version > FTransactionLogWriter::FileVersion)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s is not a transaction log this build can read"), *FilePath);
+        return false;
+    }
+
+    int64 Offset = sizeof(Magic) + sizeof(Version);
+    while (Offset + static_cast<int64>(sizeof(uint32)) <= Data.Num())
+    {
+        uint32 RecordSize = 0;
+        FMemory::Memcpy(&RecordSize, Data.GetData() + Offset, sizeof(RecordSize));
+        Offset += sizeof(RecordSize);
+
+        if (Offset + RecordSize > Data.Num())
+        {
+            // Cut off by a crash or a write still in progress
+            break;
+        }
+
+        FTransactionLogRecord& Record = OutRecords.AddDefaulted_GetRef();
+        FMemory::Memcpy(&Record, Data.GetData() + Offset, FMath::Min<uint32>(RecordSize, sizeof(FTransactionLogRecord)));
+        // Version 1 records end in compiler padding where Reserved is now
+        Record.Reserved = 0;
+        Offset += RecordSize;
+    }
+    return true;
+}
+
+bool FTransactionLogReader::ReadDirectory(const FString& Directory, TArray<FTransactionLogRecord>& OutRecords)
+{
+    TArray<FString> FileNames;
+    IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(Directory, TEXT("Transactions_*.bin")), true, false);
+    FileNames.Sort();
+
+    bool bReadAll = true;
+    for (const FString& FileName : FileNames)
+    {
+        bReadAll &= ReadFile(FPaths::Combine(Directory, FileName), OutRecords);
+    }
+    return bReadAll;
+}
+
+bool FTransactionLogReader::ExportCSV(const TArray<FTransactionLogRecord>& Records, const FString& FilePath)
+{
+    FString Output = TEXT("TransactionId,Timestamp,CheckoutId,CustomerId,SKU,Quantity,LineCents,TransactionCents\n");
+    for (const FTransactionLogRecord& Record : Records)
+    {
+        Output += FString::Printf(TEXT("%d,%.3f,%s,%d,%s,%d,%lld,%lld\n"),
+            Record.TransactionId, Record.Timestamp, *EscapeCSV(Record.CheckoutId), Record.CustomerId,
+            *EscapeCSV(Record.SKU), Record.Quantity, Record.LineCents, Record.TransactionCents);
+    }
+    return FFileHelper::SaveStringToFile(Output, *FilePath);
+}
+
+bool FTransactionLogReader::ExportJSON(const TArray<FTransactionLogRecord>& Records, const FString& FilePath)
+{
+    // One object per sale, with its SKU lines grouped back together
+    FString Output = TEXT("[\n");
+    for (int32 i = 0; i < Records.Num();)
+    {
+        const FTransactionLogRecord& First = Records[i];
+        Output += FString::Printf(TEXT("  {\"transactionId\": %d, \"timestamp\": %.3f, \"checkoutId\": \"%s\", \"customerId\": %d, \"cents\": %lld, \"items\": ["),
+            First.TransactionId, First.Timestamp, *EscapeJSON(First.CheckoutId), First.CustomerId, First.TransactionCents);
+
+        bool bFirstItem = true;
+        for (; i < Records.Num() && Records[i].TransactionId == First.TransactionId; ++i)
+        {
+            if (Records[i].SKU[0] == '\0')
+            {
+                continue;
+            }
+            Output += FString::Printf(TEXT("%s{\"sku\": \"%s\", \"quantity\": %d, \"cents\": %lld}"),
+                bFirstItem ? TEXT("") : TEXT(", "), *EscapeJSON(Records[i].SKU), Records[i].Quantity, Records[i].LineCents);
+            bFirstItem = false;
+        }
+
+        Output += i < Records.Num() ? TEXT("]},\n") : TEXT("]}\n");
+    }
+    Output += TEXT("]\n");
+    return FFileHelper::SaveStringToFile(Output, *FilePath);
+}
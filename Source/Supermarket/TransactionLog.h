@@ -0,0 +1,120 @@
+// TransactionLog.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+struct FSupermarketTransaction;
+
+// One line of a sale as stored on disk: a transaction with N SKUs is written as N records sharing
+// the TransactionId (a sale without items is a single record with an empty SKU). Fixed size and trivially
+// copyable so the game thread can hand it to the writer without allocating.
+// Written to disk as raw bytes: every byte is a named field, new fields go at the end so older files stay a prefix.
+struct FTransactionLogRecord
+{
+    int64 TransactionCents = 0;
+    double Timestamp = 0.0;
+    int32 TransactionId = 0;
+    int32 CustomerId = 0;
+    int32 Quantity = 0;
+    ANSICHAR CheckoutId[32] = {};
+    ANSICHAR SKU[32] = {};
+    uint32 Reserved = 0;
+
+    // Version 2: what this SKU line cost, zero in version 1 files
+    int64 LineCents = 0;
+};
+static_assert(sizeof(FTransactionLogRecord) == 104, "FTransactionLogRecord has implicit padding, its bytes would reach the log uninitialized");
+
+// Bounded lock-free queue, any thread can push, only the writer thread pops.
+// Every slot carries a sequence number that tells producers and the consumer whose turn it is.
+class FTransactionLogQueue
+{
+public:
+    explicit FTransactionLogQueue(uint32 InCapacity);
+
+    // Returns false when the queue is full, the record is then dropped rather than blocking the caller
+    bool Push(const FTransactionLogRecord& Record);
+    bool Pop(FTransactionLogRecord& OutRecord);
+
+    uint32 GetCapacity() const { return Mask + 1; }
+
+    // Only a hint, producers and the consumer may move it while it is being read
+    uint32 GetApproximateSize() const;
+
+private:
+    struct FSlot
+    {
+        std::atomic<uint64> Sequence;
+        FTransactionLogRecord Record;
+    };
+
+    TUniquePtr<FSlot[]> Slots;
+    uint32 Mask;
+
+    // Kept on separate cache lines, producers and the consumer touch them from different threads
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePos;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> DequeuePos;
+};
+
+// Persists every sale to an append-only file without doing any I/O on the game thread.
+// Records are queued by Append and written in batches by a background thread. Files start with a small
+// header and hold length-prefixed records. A new file is started once the current one reaches MaxFileSize.
+class SUPERMARKET_API FTransactionLogWriter : public FRunnable
+{
+public:
+    FTransactionLogWriter(const FString& InDirectory, int64 InMaxFileSize = 16 * 1024 * 1024, uint32 QueueCapacity = 16384);
+    virtual ~FTransactionLogWriter();
+
+    // Game thread side, splits the sale into records and queues them
+    void Append(const FSupermarketTransaction& Transaction);
+
+    // Records lost because the queue was full
+    int32 GetNumDroppedRecords() const { return NumDroppedRecords.load(std::memory_order_relaxed); }
+
+    const FString& GetDirectory() const { return Directory; }
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+    static const uint32 FileMagic = 0x474C5853; // "SXLG"
+    static const uint32 FileVersion = 2;
+
+private:
+    void WriteBatch(TArray<uint8>& Batch);
+    bool OpenNewFile();
+
+    FString Directory;
+    int64 MaxFileSize;
+
+    FTransactionLogQueue Queue;
+    std::atomic<int32> NumDroppedRecords;
+    std::atomic<bool> bStopping;
+
+    FEvent* WakeEvent;
+    FRunnableThread* Thread;
+
+    // Writer thread only
+    IFileHandle* FileHandle;
+    int64 FileSize;
+    int32 FileIndex;
+};
+
+// Reads log files back for analysis, outside of the game loop
+class SUPERMARKET_API FTransactionLogReader
+{
+public:
+    // Reads every record of one log file, stops at the first truncated record
+    static bool ReadFile(const FString& FilePath, TArray<FTransactionLogRecord>& OutRecords);
+
+    // Reads all log files of a directory in the order they were written
+    static bool ReadDirectory(const FString& Directory, TArray<FTransactionLogRecord>& OutRecords);
+
+    static bool ExportCSV(const TArray<FTransactionLogRecord>& Records, const FString& FilePath);
+    static bool ExportJSON(const TArray<FTransactionLogRecord>& Records, const FString& FilePath);
+};
@@ -0,0 +1,386 @@
+// StoreSimulation.cpp
+#include "StoreSimulation.h"
+#include "Algo/BinarySearch.h"
+
+FStoreSimulation::FStoreSimulation(const FStoreSimConfig& InConfig)
+    : Config(InConfig)
+    , Random(static_cast<int32>(InConfig.Seed))
+{
+    Config.FixedTimestep = FMath::Max(Config.FixedTimestep, KINDA_SMALL_NUMBER);
+    TimeToNextRestock = Config.RestockInterval;
+}
+
+int32 FStoreSimulation::AddProduct(FName SKU, int64 PriceCents)
+{
+    FSimProduct& Product = Products.AddDefaulted_GetRef();
+    Product.SKU = SKU;
+    Product.PriceCents = PriceCents;
+    return Products.Num() - 1;
+}
+
+int32 FStoreSimulation::AddShelf(const FVector& Location, int32 ProductIndex, int32 Capacity, int32 InitialStock)
+{
+    check(Products.IsValidIndex(ProductIndex));
+
+    FSimShelf& Shelf = Shelves.AddDefaulted_GetRef();
+    Shelf.Location = Location;
+    Shelf.ProductIndex = ProductIndex;
+    Shelf.Capacity = FMath::Max(Capacity, 0);
+    Shelf.Stock = FMath::Clamp(InitialStock, 0, Shelf.Capacity);
+    return Shelves.Num() - 1;
+}
+
+int32 FStoreSimulation::AddCheckout(const FVector& Location)
+{
+    FSimCheckout& Checkout = Checkouts.AddDefaulted_GetRef();
+    Checkout.Location = Location;
+    return Checkouts.Num() - 1;
+}
+
+int32 FStoreSimulation::SpawnCustomer()
+{
+    // Ids only grow, so appending keeps Customers sorted by id
+    FSimCustomer& Customer = Customers.AddDefaulted_GetRef();
+    Customer.Id = NextCustomerId++;
+    Customer.Location = Entrance;
+    Customer.ItemsWanted = Random.RandRange(Config.MinItems, FMath::Max(Config.MinItems, Config.MaxItems));
+    Customer.ArrivalTime = Time;
+    Customer.State = ESimCustomerState::ChoosingShelf;
+
+    Stats.CustomersArrived++;
+    return Customer.Id;
+}
+
+void FStoreSimulation::Step(float DeltaTime)
+{
+    Accumulator += FMath::Max(static_cast<double>(DeltaTime), 0.0);
+    while (Accumulator >= Config.FixedTimestep)
+    {
+        FixedStep(Config.FixedTimestep);
+        Accumulator -= Config.FixedTimestep;
+    }
+}
+
+void FStoreSimulation::RunFor(float Duration)
+{
+    const int32 NumSteps = FMath::FloorToInt(FMath::Max(Duration, 0.0f) / Config.FixedTimestep);
+    for (int32 i = 0; i < NumSteps; i++)
+    {
+        FixedStep(Config.FixedTimestep);
+    }
+}
+
+void FStoreSimulation::FixedStep(float Dt)
+{
+    StepCount++;
+    Time = StepCount * static_cast<double>(Dt);
+
+    UpdateArrivals(Dt);
+    UpdateRestocking(Dt);
+
+    for (int32 CheckoutIndex = 0; CheckoutIndex < Checkouts.Num(); CheckoutIndex++)
+    {
+        UpdateCheckout(CheckoutIndex, Dt);
+    }
+
+    for (FSimCustomer& Customer : Customers)
+    {
+        UpdateCustomer(Customer, Dt);
+    }
+
+    Customers.RemoveAll([](const FSimCustomer& Customer) { return Customer.State == ESimCustomerState::Left; });
+}
+
+void FStoreSimulation::UpdateArrivals(float Dt)
+{
+    if (!bAutomaticArrivals || Config.ArrivalInterval <= 0.0f)
+    {
+        return;
+    }
+
+    TimeToNextArrival -= Dt;
+    while (TimeToNextArrival <= 0.0f)
+    {
+        TimeToNextArrival += Config.ArrivalInterval;
+        if (Customers.Num() < Config.MaxCustomers)
+        {
+            SpawnCustomer();
+        }
+    }
+}
+
+void FStoreSimulation::UpdateRestocking(float Dt)
+{
+    if (Config.RestockInterval <= 0.0f)
+    {
+        return;
+    }
+
+    TimeToNextRestock -= Dt;
+    if (TimeToNextRestock > 0.0f)
+    {
+        return;
+    }
+    TimeToNextRestock += Config.RestockInterval;
+
+    for (FSimShelf& Shelf : Shelves)
+    {
+        if (Shelf.Stock <= Config.RestockThreshold)
+        {
+            Stats.UnitsRestocked += Shelf.Capacity - Shelf.Stock;
+            Shelf.Stock = Shelf.Capacity;
+        }
+    }
+}
+
+void FStoreSimulation::UpdateCustomer(FSimCustomer& Customer, float Dt)
+{
+    switch (Customer.State)
+    {
+    case ESimCustomerState::ChoosingShelf:
+        ChooseShelf(Customer);
+        break;
+
+    case ESimCustomerState::WalkingToShelf:
+        Customer.TimeLeft -= Dt;
+        if (Customer.TimeLeft <= 0.0f)
+        {
+            Customer.Location = Shelves[Customer.TargetShelf].Location;
+            Customer.State = ESimCustomerState::Picking;
+            Customer.TimeLeft = Config.PickTime;
+        }
+        break;
+
+    case ESimCustomerState::Picking:
+        Customer.TimeLeft -= Dt;
+        if (Customer.TimeLeft <= 0.0f)
+        {
+            PickFromShelf(Customer);
+        }
+        break;
+
+    case ESimCustomerState::WaitingForStock:
+        Customer.TimeLeft -= Dt;
+        if (Customer.TimeLeft <= 0.0f)
+        {
+            Customer.State = ESimCustomerState::ChoosingShelf;
+        }
+        break;
+
+    case ESimCustomerState::WalkingToCheckout:
+        Customer.TimeLeft -= Dt;
+        if (Customer.TimeLeft <= 0.0f)
+        {
+            Customer.Location = Checkouts[Customer.TargetCheckout].Location;
+            TryJoinQueue(Customer);
+        }
+        break;
+
+    case ESimCustomerState::WaitingForQueue:
+        Customer.TimeLeft -= Dt;
+        if (Customer.TimeLeft <= 0.0f)
+        {
+            GoToCheckout(Customer);
+        }
+        break;
+
+    case ESimCustomerState::Leaving:
+        Customer.TimeLeft -= Dt;
+        if (Customer.TimeLeft <= 0.0f)
+        {
+            Customer.State = ESimCustomerState::Left;
+        }
+        break;
+
+    case ESimCustomerState::Queued:
+    case ESimCustomerState::BeingServed:
+    case ESimCustomerState::Left:
+        // Driven by the checkout
+        break;
+    }
+}
+
+void FStoreSimulation::ChooseShelf(FSimCustomer& Customer)
+{
+    if (Customer.ItemsInBag >= Customer.ItemsWanted || Time - Customer.ArrivalTime >= Config.ShoppingTime)
+    {
+        GoToCheckout(Customer);
+        return;
+    }
+
+    // Any stocked shelf, picked at random like AAICustomerPawn::ChooseProduct
+    int32 NumStocked = 0;
+    for (const FSimShelf& Shelf : Shelves)
+    {
+        NumStocked += Shelf.Stock > 0 ? 1 : 0;
+    }
+
+    if (NumStocked == 0)
+    {
+        Customer.State = ESimCustomerState::WaitingForStock;
+        Customer.TimeLeft = Config.NoStockRetryDelay;
+        return;
+    }
+
+    int32 Choice = Random.RandHelper(NumStocked);
+    for (int32 ShelfIndex = 0; ShelfIndex < Shelves.Num(); ShelfIndex++)
+    {
+        if (Shelves[ShelfIndex].Stock > 0 && Choice-- == 0)
+        {
+            Customer.TargetShelf = ShelfIndex;
+            break;
+        }
+    }
+
+    Customer.State = ESimCustomerState::WalkingToShelf;
+    Customer.TimeLeft = WalkTime(Customer.Location, Shelves[Customer.TargetShelf].Location);
+}
+
+void FStoreSimulation::PickFromShelf(FSimCustomer& Customer)
+{
+    FSimShelf& Shelf = Shelves[Customer.TargetShelf];
+    if (Shelf.Stock <= 0)
+    {
+        // Someone else took the last one while we walked over
+        Stats.FailedPicks++;
+        Customer.State = ESimCustomerState::ChoosingShelf;
+        return;
+    }
+
+    Shelf.Stock--;
+
+    FSimBagLine* Line = Customer.Bag.FindByPredicate([&Shelf](const FSimBagLine& Existing) { return Existing.ProductIndex == Shelf.ProductIndex; });
+    if (!Line)
+    {
+        Line = &Customer.Bag.AddDefaulted_GetRef();
+        Line->ProductIndex = Shelf.ProductIndex;
+    }
+    Line->Quantity++;
+    Customer.ItemsInBag++;
+    Customer.BagCents += Products[Shelf.ProductIndex].PriceCents;
+
+    Customer.State = ESimCustomerState::ChoosingShelf;
+}
+
+void FStoreSimulation::GoToCheckout(FSimCustomer& Customer)
+{
+    if (Customer.ItemsInBag == 0 || Checkouts.Num() == 0)
+    {
+        Stats.CustomersLeftEmptyHanded++;
+        StartLeaving(Customer);
+        return;
+    }
+
+    // Shortest queue, the customer being served counts as one
+    int32 BestCheckout = 0;
+    int32 BestLength = MAX_int32;
+    for (int32 CheckoutIndex = 0; CheckoutIndex < Checkouts.Num(); CheckoutIndex++)
+    {
+        const FSimCheckout& Checkout = Checkouts[CheckoutIndex];
+        const int32 Length = Checkout.Queue.Num() + (Checkout.ServingCustomer != INDEX_NONE ? 1 : 0);
+        if (Length < BestLength)
+        {
+            BestLength = Length;
+            BestCheckout = CheckoutIndex;
+        }
+    }
+
+    Customer.TargetCheckout = BestCheckout;
+    Customer.State = ESimCustomerState::WalkingToCheckout;
+    Customer.TimeLeft = WalkTime(Customer.Location, Checkouts[BestCheckout].Location);
+}
+
+void FStoreSimulation::TryJoinQueue(FSimCustomer& Customer)
+{
+    FSimCheckout& Checkout = Checkouts[Customer.TargetCheckout];
+    if (Checkout.Queue.Num() >= Config.MaxQueueLength)
+    {
+        Customer.State = ESimCustomerState::WaitingForQueue;
+        Customer.TimeLeft = Config.QueueRetryDelay;
+        return;
+    }
+
+    Checkout.Queue.Add(Customer.Id);
+    Customer.State = ESimCustomerState::Queued;
+    Customer.QueueJoinTime = Time;
+    Stats.MaxQueueLength = FMath::Max(Stats.MaxQueueLength, Checkout.Queue.Num());
+}
+
+void FStoreSimulation::UpdateCheckout(int32 CheckoutIndex, float Dt)
+{
+    FSimCheckout& Checkout = Checkouts[CheckoutIndex];
+
+    if (Checkout.ServingCustomer != INDEX_NONE)
+    {
+        Checkout.BusyTime += Dt;
+        Checkout.ServiceTimeLeft -= Dt;
+        if (Checkout.ServiceTimeLeft <= 0.0f)
+        {
+            FinishService(CheckoutIndex);
+        }
+    }
+
+    if (Checkout.ServingCustomer == INDEX_NONE && Checkout.Queue.Num() > 0)
+    {
+        const int32 CustomerId = Checkout.Queue[0];
+        Checkout.Queue.RemoveAt(0);
+
+        if (FSimCustomer* Customer = FindCustomer(CustomerId))
+        {
+            Checkout.ServingCustomer = CustomerId;
+            Checkout.ServiceTimeLeft = Customer->ItemsInBag * Config.ScanTimePerItem + Config.PaymentTime;
+            Customer->State = ESimCustomerState::BeingServed;
+            Stats.QueueWaits.Add(static_cast<float>(Time - Customer->QueueJoinTime));
+        }
+    }
+}
+
+void FStoreSimulation::FinishService(int32 CheckoutIndex)
+{
+    FSimCheckout& Checkout = Checkouts[CheckoutIndex];
+    FSimCustomer* Customer = FindCustomer(Checkout.ServingCustomer);
+    Checkout.ServingCustomer = INDEX_NONE;
+    Checkout.CustomersServed++;
+
+    if (!Customer)
+    {
+        return;
+    }
+
+    FSimSale Sale;
+    Sale.Time = Time;
+    Sale.CheckoutIndex = CheckoutIndex;
+    Sale.CustomerId = Customer->Id;
+    Sale.Items = Customer->Bag;
+    Sale.Cents = Customer->BagCents;
+
+    Stats.CustomersServed++;
+    Stats.ItemsSold += Customer->ItemsInBag;
+    Stats.RevenueCents += Customer->BagCents;
+
+    if (OnSale)
+    {
+        OnSale(Sale);
+    }
+
+    StartLeaving(*Customer);
+    Stats.TimesInStore.Add(static_cast<float>(Customer->LeaveTime - Customer->ArrivalTime));
+}
+
+void FStoreSimulation::StartLeaving(FSimCustomer& Customer)
+{
+    Customer.State = ESimCustomerState::Leaving;
+    Customer.TimeLeft = WalkTime(Customer.Location, Entrance);
+    Customer.LeaveTime = Time + Customer.TimeLeft;
+}
+
+float FStoreSimulation::WalkTime(const FVector& From, const FVector& To) const
+{
+    return Config.WalkSpeed > 0.0f ? FVector::Dist(From, To) / Config.WalkSpeed : 0.0f;
+}
+
+FSimCustomer* FStoreSimulation::FindCustomer(int32 CustomerId)
+{
+    const int32 Index = Algo::LowerBoundBy(Customers, CustomerId, [](const FSimCustomer& Customer) { return Customer.Id; });
+    return Customers.IsValidIndex(Index) && Customers[Index].Id == CustomerId ? &Customers[Index] : nullptr;
+}
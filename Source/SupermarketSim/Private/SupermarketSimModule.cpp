@@ -0,0 +1,4 @@
+// SupermarketSimModule.cpp
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, SupermarketSim);
@@ -0,0 +1,127 @@
+// StoreSimulation.spec.cpp
+#include "StoreSimulation.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+BEGIN_DEFINE_SPEC(FStoreSimulationSpec, "Supermarket.StoreSimulation",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+    // Two products on four shelves and two checkouts, restocked often enough to keep customers coming back
+    static FStoreSimConfig MakeConfig(uint32 Seed)
+    {
+        FStoreSimConfig Config;
+        Config.Seed = Seed;
+        Config.ArrivalInterval = 15.0f;
+        Config.RestockInterval = 120.0f;
+        Config.RestockThreshold = 2;
+        return Config;
+    }
+
+    static void SetupStore(FStoreSimulation& Simulation)
+    {
+        const int32 Milk = Simulation.AddProduct(TEXT("Milk"), 129);
+        const int32 Bread = Simulation.AddProduct(TEXT("Bread"), 249);
+        Simulation.AddShelf(FVector(500.0f, 0.0f, 0.0f), Milk, 20, 20);
+        Simulation.AddShelf(FVector(500.0f, 400.0f, 0.0f), Milk, 20, 10);
+        Simulation.AddShelf(FVector(900.0f, 0.0f, 0.0f), Bread, 15, 15);
+        Simulation.AddShelf(FVector(900.0f, 400.0f, 0.0f), Bread, 15, 0);
+        Simulation.AddCheckout(FVector(100.0f, 200.0f, 0.0f));
+        Simulation.AddCheckout(FVector(100.0f, 400.0f, 0.0f));
+        Simulation.SetEntrance(FVector::ZeroVector);
+    }
+
+    static int32 CountStock(const FStoreSimulation& Simulation)
+    {
+        int32 Stock = 0;
+        for (const FSimShelf& Shelf : Simulation.GetShelves())
+        {
+            Stock += Shelf.Stock;
+        }
+        return Stock;
+    }
+
+    // Stops arrivals and runs until every customer in the store has paid or given up
+    static void Drain(FStoreSimulation& Simulation)
+    {
+        Simulation.SetAutomaticArrivals(false);
+        for (int32 Minute = 0; Minute < 120 && Simulation.GetNumCustomersInStore() > 0; ++Minute)
+        {
+            Simulation.RunFor(60.0f);
+        }
+    }
+
+END_DEFINE_SPEC(FStoreSimulationSpec)
+
+void FStoreSimulationSpec::Define()
+{
+    It("produces the same stats for the same seed", [this]()
+    {
+        FStoreSimulation First(MakeConfig(7));
+        FStoreSimulation Second(MakeConfig(7));
+        SetupStore(First);
+        SetupStore(Second);
+        First.RunFor(4.0f * 3600.0f);
+        Second.RunFor(4.0f * 3600.0f);
+
+        const FStoreSimStats& A = First.GetStats();
+        const FStoreSimStats& B = Second.GetStats();
+        TestTrue(TEXT("Customers arrived"), A.CustomersArrived > 0);
+        TestEqual(TEXT("CustomersArrived"), A.CustomersArrived, B.CustomersArrived);
+        TestEqual(TEXT("CustomersServed"), A.CustomersServed, B.CustomersServed);
+        TestEqual(TEXT("CustomersLeftEmptyHanded"), A.CustomersLeftEmptyHanded, B.CustomersLeftEmptyHanded);
+        TestEqual(TEXT("ItemsSold"), A.ItemsSold, B.ItemsSold);
+        TestEqual(TEXT("RevenueCents"), A.RevenueCents, B.RevenueCents);
+        TestEqual(TEXT("FailedPicks"), A.FailedPicks, B.FailedPicks);
+        TestEqual(TEXT("UnitsRestocked"), A.UnitsRestocked, B.UnitsRestocked);
+        TestEqual(TEXT("MaxQueueLength"), A.MaxQueueLength, B.MaxQueueLength);
+        TestTrue(TEXT("TimesInStore"), A.TimesInStore == B.TimesInStore);
+        TestTrue(TEXT("QueueWaits"), A.QueueWaits == B.QueueWaits);
+        TestEqual(TEXT("Time"), First.GetTime(), Second.GetTime());
+    });
+
+    It("conserves stock", [this]()
+    {
+        FStoreSimulation Simulation(MakeConfig(11));
+        SetupStore(Simulation);
+        const int32 InitialStock = CountStock(Simulation);
+
+        Simulation.RunFor(3.0f * 3600.0f);
+        Drain(Simulation);
+
+        const FStoreSimStats& Stats = Simulation.GetStats();
+        TestEqual(TEXT("Customers in store after draining"), Simulation.GetNumCustomersInStore(), 0);
+        TestTrue(TEXT("Items sold"), Stats.ItemsSold > 0);
+        TestEqual(TEXT("Sold plus remaining"), Stats.ItemsSold + CountStock(Simulation), InitialStock + Stats.UnitsRestocked);
+    });
+
+    It("reports revenue equal to the sum of its sales", [this]()
+    {
+        FStoreSimulation Simulation(MakeConfig(3));
+        SetupStore(Simulation);
+
+        int64 SaleCents = 0;
+        int32 SaleItems = 0;
+        int32 NumSales = 0;
+        Simulation.OnSale = [&](const FSimSale& Sale)
+        {
+            SaleCents += Sale.Cents;
+            for (const FSimBagLine& Line : Sale.Items)
+            {
+                SaleItems += Line.Quantity;
+            }
+            NumSales++;
+        };
+
+        Simulation.RunFor(2.0f * 3600.0f);
+        Drain(Simulation);
+
+        const FStoreSimStats& Stats = Simulation.GetStats();
+        TestTrue(TEXT("Sales"), NumSales > 0);
+        TestEqual(TEXT("Sales"), NumSales, Stats.CustomersServed);
+        TestEqual(TEXT("RevenueCents"), Stats.RevenueCents, SaleCents);
+        TestEqual(TEXT("ItemsSold"), Stats.ItemsSold, SaleItems);
+    });
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
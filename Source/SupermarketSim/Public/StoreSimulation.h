@@ -0,0 +1,225 @@
+// StoreSimulation.h
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+// Tuning of the simulated store. Defaults follow the gameplay actors (AAICustomerPawn, ACheckout).
+struct SUPERMARKETSIM_API FStoreSimConfig
+{
+    // Fixed timestep Step() advances the simulation with, in seconds
+    float FixedTimestep = 0.1f;
+
+    uint32 Seed = 1;
+
+    // Customer arrivals, one every ArrivalInterval seconds while fewer than MaxCustomers are in the store
+    float ArrivalInterval = 20.0f;
+    int32 MaxCustomers = 50;
+
+    // Items a customer wants, picked uniformly like AAICustomerPawn::MaxItems
+    int32 MinItems = 2;
+    int32 MaxItems = 12;
+
+    // Customers give up shopping after this long and go to the checkout with what they have
+    float ShoppingTime = 300.0f;
+
+    // Wait before looking again when no shelf is stocked
+    float NoStockRetryDelay = 2.0f;
+
+    float WalkSpeed = 150.0f;
+
+    // Reaching for a product and putting it in the bag
+    float PickTime = 1.5f;
+
+    float ScanTimePerItem = 0.75f;
+    float PaymentTime = 3.0f;
+
+    // Customers beyond this many in a checkout's queue try another checkout or wait
+    int32 MaxQueueLength = 6;
+    float QueueRetryDelay = 2.0f;
+
+    // Stand-in for the player: shelves at or below the threshold are refilled every RestockInterval seconds.
+    // A RestockInterval of 0 disables restocking.
+    float RestockInterval = 0.0f;
+    int32 RestockThreshold = 0;
+};
+
+struct SUPERMARKETSIM_API FSimProduct
+{
+    FName SKU;
+    int64 PriceCents = 0;
+};
+
+struct SUPERMARKETSIM_API FSimShelf
+{
+    FVector Location = FVector::ZeroVector;
+    int32 ProductIndex = INDEX_NONE;
+    int32 Stock = 0;
+    int32 Capacity = 0;
+};
+
+struct SUPERMARKETSIM_API FSimCheckout
+{
+    FVector Location = FVector::ZeroVector;
+
+    // Customer ids waiting, the front one is served next
+    TArray<int32> Queue;
+
+    // Customer being served and the time left on their basket
+    int32 ServingCustomer = INDEX_NONE;
+    float ServiceTimeLeft = 0.0f;
+
+    int32 CustomersServed = 0;
+    float BusyTime = 0.0f;
+};
+
+enum class ESimCustomerState : uint8
+{
+    ChoosingShelf,
+    WalkingToShelf,
+    Picking,
+    WaitingForStock,
+    WalkingToCheckout,
+    WaitingForQueue,
+    Queued,
+    BeingServed,
+    Leaving,
+    Left
+};
+
+struct SUPERMARKETSIM_API FSimBagLine
+{
+    int32 ProductIndex = INDEX_NONE;
+    int32 Quantity = 0;
+};
+
+struct SUPERMARKETSIM_API FSimCustomer
+{
+    int32 Id = INDEX_NONE;
+    ESimCustomerState State = ESimCustomerState::ChoosingShelf;
+    FVector Location = FVector::ZeroVector;
+
+    int32 ItemsWanted = 0;
+    int32 ItemsInBag = 0;
+    int64 BagCents = 0;
+    TArray<FSimBagLine> Bag;
+
+    int32 TargetShelf = INDEX_NONE;
+    int32 TargetCheckout = INDEX_NONE;
+
+    // Time left on the current walk, pick or wait
+    float TimeLeft = 0.0f;
+
+    double ArrivalTime = 0.0;
+    double QueueJoinTime = 0.0;
+    double LeaveTime = 0.0;
+};
+
+// A sale completed at a checkout
+struct SUPERMARKETSIM_API FSimSale
+{
+    double Time = 0.0;
+    int32 CheckoutIndex = INDEX_NONE;
+    int32 CustomerId = INDEX_NONE;
+    TArray<FSimBagLine> Items;
+    int64 Cents = 0;
+};
+
+struct SUPERMARKETSIM_API FStoreSimStats
+{
+    int32 CustomersArrived = 0;
+    int32 CustomersServed = 0;
+    int32 CustomersLeftEmptyHanded = 0;
+    int32 ItemsSold = 0;
+    int64 RevenueCents = 0;
+
+    // Shelf visits that found the shelf empty
+    int32 FailedPicks = 0;
+
+    int32 UnitsRestocked = 0;
+    int32 MaxQueueLength = 0;
+
+    // Per served customer, in seconds
+    TArray<float> TimesInStore;
+    TArray<float> QueueWaits;
+};
+
+// The shopping loop of the store as plain data, stepped with a fixed timestep and no world, timers or
+// navmesh. Walking is a straight line at WalkSpeed. Runs are deterministic for a given config and setup,
+// so a trading day can be simulated in well under a second and compared run to run.
+class SUPERMARKETSIM_API FStoreSimulation
+{
+public:
+    explicit FStoreSimulation(const FStoreSimConfig& InConfig = FStoreSimConfig());
+
+    int32 AddProduct(FName SKU, int64 PriceCents);
+    int32 AddShelf(const FVector& Location, int32 ProductIndex, int32 Capacity, int32 InitialStock);
+    int32 AddCheckout(const FVector& Location);
+    void SetEntrance(const FVector& Location) { Entrance = Location; }
+
+    // Lets a customer in right now, independent of the arrival interval. Returns the customer id.
+    int32 SpawnCustomer();
+
+    // Advances by DeltaTime, in as many fixed steps as fit. The remainder carries over to the next call.
+    void Step(float DeltaTime);
+
+    // Runs whole fixed steps until Duration seconds of store time have passed
+    void RunFor(float Duration);
+
+    // Fired for every completed sale, from inside Step
+    TFunction<void(const FSimSale&)> OnSale;
+
+    double GetTime() const { return Time; }
+    const FStoreSimConfig& GetConfig() const { return Config; }
+    const FStoreSimStats& GetStats() const { return Stats; }
+    const TArray<FSimProduct>& GetProducts() const { return Products; }
+    const TArray<FSimShelf>& GetShelves() const { return Shelves; }
+    const TArray<FSimCheckout>& GetCheckouts() const { return Checkouts; }
+    const TArray<FSimCustomer>& GetCustomers() const { return Customers; }
+    int32 GetNumCustomersInStore() const { return Customers.Num(); }
+
+    // Automatic arrivals can be turned off to drive them from a schedule with SpawnCustomer
+    void SetAutomaticArrivals(bool bEnabled) { bAutomaticArrivals = bEnabled; }
+
+    // Changes the arrival interval from now on, e.g. to follow a time-of-day curve
+    void SetArrivalInterval(float Interval) { Config.ArrivalInterval = Interval; }
+
+private:
+    void FixedStep(float Dt);
+    void UpdateArrivals(float Dt);
+    void UpdateRestocking(float Dt);
+    void UpdateCustomer(FSimCustomer& Customer, float Dt);
+    void UpdateCheckout(int32 CheckoutIndex, float Dt);
+
+    void ChooseShelf(FSimCustomer& Customer);
+    void PickFromShelf(FSimCustomer& Customer);
+    void GoToCheckout(FSimCustomer& Customer);
+    void TryJoinQueue(FSimCustomer& Customer);
+    void FinishService(int32 CheckoutIndex);
+    void StartLeaving(FSimCustomer& Customer);
+
+    float WalkTime(const FVector& From, const FVector& To) const;
+    FSimCustomer* FindCustomer(int32 CustomerId);
+
+    FStoreSimConfig Config;
+    FRandomStream Random;
+
+    TArray<FSimProduct> Products;
+    TArray<FSimShelf> Shelves;
+    TArray<FSimCheckout> Checkouts;
+
+    // Customers in the store, removed once they have left. Sorted by id.
+    TArray<FSimCustomer> Customers;
+
+    FVector Entrance = FVector::ZeroVector;
+    FStoreSimStats Stats;
+
+    // Derived from the step count, so it does not drift over a long run the way a summed float would
+    double Time = 0.0;
+    int64 StepCount = 0;
+    double Accumulator = 0.0;
+    float TimeToNextArrival = 0.0f;
+    float TimeToNextRestock = 0.0f;
+    int32 NextCustomerId = 1;
+    bool bAutomaticArrivals = true;
+};
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Store simulation without UObjects, actors or a world. Only depends on Core so it can be stepped
+// from game code, commandlets and tests alike.
+public class SupermarketSim : ModuleRules
+{
+	public SupermarketSim(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}